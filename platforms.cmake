@@ -1,3 +1,4 @@
-# \/=== Enable/disable AVR32 and/or Windows build below- set as ON or OFF
+# \/=== Enable/disable AVR32, Windows, and/or Linux build below- set as ON or OFF
 set(SUPPORTS_AVR32 ON)
-set(SUPPORTS_WINDOWS ON)
\ No newline at end of file
+set(SUPPORTS_WINDOWS ON)
+set(SUPPORTS_LINUX ON)
\ No newline at end of file
@@ -0,0 +1,262 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_collector.c                                   */
+/*                                                                            */
+/* Reference collector for runtime_exporter.c streams- for local testing      */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+/* for SOCK_CLOEXEC w/ -std=c11 */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "runtime_export_format.h"
+
+/*----------------------------------------------------------------------------*/
+/*                           Struct, Enum, Typedefs                           */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    MAX_EXPORTERS = 64,
+    RECEIVE_BUFFER_SIZE = 32768
+};
+
+struct exporter_connection {
+    int fd;
+    uint32_t received_size;
+    uint8_t receive_buffer[RECEIVE_BUFFER_SIZE];
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static void stop_collecting(int signal_number);
+static int listen_on_socket(const char *socket_path);
+static void accept_exporter(int listen_fd);
+static bool receive_from_exporter(struct exporter_connection *connection);
+static bool decode_frame(const uint8_t *frame, uint32_t available_size, uint32_t *frame_size);
+static uint16_t get_u16(const uint8_t *source);
+static uint32_t get_u32(const uint8_t *source);
+
+/*----------------------------------------------------------------------------*/
+/*                               Private Globals                              */
+/*----------------------------------------------------------------------------*/
+const char *collector_category_names[] = {"telemetry", "warning", "error"};
+
+volatile sig_atomic_t collecting = 1;
+struct exporter_connection exporter_connections[MAX_EXPORTERS];
+
+/*----------------------------------------------------------------------------*/
+/*                                    Main                                    */
+/*----------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <socket path>\n", argv[0]);
+        return 1;
+    }
+
+    int listen_fd = listen_on_socket(argv[1]);
+    if (listen_fd < 0) {
+        perror("runtime_collector");
+        return 1;
+    }
+
+    signal(SIGINT, stop_collecting);
+    signal(SIGTERM, stop_collecting);
+    for (uint32_t i = 0u; i < MAX_EXPORTERS; i++) {
+        exporter_connections[i].fd = -1;
+    }
+
+    while (collecting) {
+        struct pollfd poll_fds[MAX_EXPORTERS + 1];
+        poll_fds[0] = (struct pollfd){listen_fd, POLLIN, 0};
+        for (uint32_t i = 0u; i < MAX_EXPORTERS; i++) {
+            poll_fds[i + 1] = (struct pollfd){exporter_connections[i].fd, POLLIN, 0};
+        }
+
+        if (poll(poll_fds, MAX_EXPORTERS + 1, -1) < 0) {
+            continue;
+        }
+
+        if ((poll_fds[0].revents & POLLIN) != 0) {
+            accept_exporter(listen_fd);
+        }
+        for (uint32_t i = 0u; i < MAX_EXPORTERS; i++) {
+            if ((poll_fds[i + 1].revents != 0)
+                && !receive_from_exporter(&exporter_connections[i])) {
+                close(exporter_connections[i].fd);
+                exporter_connections[i].fd = -1;
+            }
+        }
+        fflush(stdout);
+    }
+
+    close(listen_fd);
+    unlink(argv[1]);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static void stop_collecting(int signal_number)
+{
+    (void)signal_number;
+    collecting = 0;
+}
+
+static int listen_on_socket(const char *socket_path)
+{
+    struct sockaddr_un address;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+    unlink(socket_path);
+    if ((bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+        || (listen(fd, MAX_EXPORTERS) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_exporter(int listen_fd)
+{
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+
+    for (uint32_t i = 0u; i < MAX_EXPORTERS; i++) {
+        if (exporter_connections[i].fd < 0) {
+            exporter_connections[i].fd = fd;
+            exporter_connections[i].received_size = 0u;
+            return;
+        }
+    }
+    close(fd);
+}
+
+static bool receive_from_exporter(struct exporter_connection *connection)
+{
+    uint8_t *receive_end = &connection->receive_buffer[connection->received_size];
+    ssize_t received = read(connection->fd, receive_end,
+                            RECEIVE_BUFFER_SIZE - connection->received_size);
+    if (received <= 0) {
+        return (received < 0) && (errno == EINTR);
+    }
+    connection->received_size += (uint32_t)received;
+
+    uint32_t decoded_size = 0u;
+    uint32_t frame_size = 0u;
+    do {
+        if (!decode_frame(&connection->receive_buffer[decoded_size],
+                          connection->received_size - decoded_size, &frame_size)) {
+            return false;
+        }
+        decoded_size += frame_size;
+    } while (frame_size != 0u);
+
+    memmove(connection->receive_buffer, &connection->receive_buffer[decoded_size],
+            connection->received_size - decoded_size);
+    connection->received_size -= decoded_size;
+
+    /* a frame that can never fit means the stream is corrupt */
+    return connection->received_size < RECEIVE_BUFFER_SIZE;
+}
+
+/*
+ * frame_size is the size of the decoded frame, or 0 if it isn't complete yet.
+ * Returns false if the frame size is corrupt- smaller than the header, or too
+ * big to ever fit the receive buffer
+ */
+static bool decode_frame(const uint8_t *frame, uint32_t available_size, uint32_t *frame_size)
+{
+    *frame_size = 0u;
+    if (available_size < EXPORT_FRAME_HEADER_SIZE) {
+        return true;
+    }
+
+    /* checked before adding the size field's own 4 bytes, so it can't overflow */
+    uint32_t size_after_size_field = get_u32(&frame[0]);
+    if ((size_after_size_field < (EXPORT_FRAME_HEADER_SIZE - sizeof(uint32_t)))
+        || (size_after_size_field > (RECEIVE_BUFFER_SIZE - sizeof(uint32_t)))) {
+        fprintf(stderr, "corrupt frame size %" PRIu32 ", disconnecting\n",
+                size_after_size_field);
+        return false;
+    }
+    if (available_size < (sizeof(uint32_t) + size_after_size_field)) {
+        return true;
+    }
+    *frame_size = sizeof(uint32_t) + size_after_size_field;
+
+    uint32_t pid = get_u32(&frame[8]);
+    uint32_t dropped_entry_count = get_u32(&frame[12]);
+    uint16_t entry_count = get_u16(&frame[16]);
+    if ((get_u16(&frame[4]) != EXPORT_FRAME_MAGIC) || (frame[6] != EXPORT_FRAME_VERSION)) {
+        fprintf(stderr, "[%" PRIu32 "] unknown frame format, skipped\n", pid);
+        return true;
+    }
+
+    if (dropped_entry_count != 0u) {
+        printf("[%" PRIu32 "] dropped %" PRIu32 "\n", pid, dropped_entry_count);
+    }
+
+    uint32_t offset = EXPORT_FRAME_HEADER_SIZE;
+    for (uint16_t i = 0u; i < entry_count; i++) {
+        if ((offset + EXPORT_ENTRY_HEADER_SIZE) > *frame_size) {
+            break;
+        }
+
+        const uint8_t *entry = &frame[offset];
+        uint8_t category = entry[12];
+        uint8_t message_length = entry[13];
+        if ((offset + EXPORT_ENTRY_HEADER_SIZE + message_length) > *frame_size) {
+            break;
+        }
+
+        const char *category_name = (category < 3u) ? collector_category_names[category]
+                                                    : "unknown";
+        const char *message = (const char *)&entry[EXPORT_ENTRY_HEADER_SIZE];
+        printf("[%" PRIu32 "] %s #%" PRIu32 ": %" PRIu32 " %.*s %" PRIu32 "\n", pid,
+               category_name, get_u32(&entry[0]), get_u32(&entry[4]), (int)message_length,
+               message, get_u32(&entry[8]));
+        offset += EXPORT_ENTRY_HEADER_SIZE + message_length;
+    }
+
+    return true;
+}
+
+static uint16_t get_u16(const uint8_t *source)
+{
+    return (uint16_t)(source[0] | (source[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *source)
+{
+    return (uint32_t)source[0] | ((uint32_t)source[1] << 8) | ((uint32_t)source[2] << 16)
+           | ((uint32_t)source[3] << 24);
+}
@@ -0,0 +1,340 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : handler_dispatch.c                                    */
+/*                                                                            */
+/* Lock-free posting of user handlers w/ coalescing and re-entrancy guard     */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "handler_dispatch.h"
+#include "runtime_atomics.h"
+#include "self_profiling_probes.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                           Struct, Enum, Typedefs                           */
+/*----------------------------------------------------------------------------*/
+typedef void (*handler_function)(void);
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t get_handler_event_bit(enum handler_event event);
+static void post_handler_event(enum handler_event event, handler_function handler);
+static void call_handler(enum handler_event event, handler_function handler);
+static bool enter_handler(void);
+static void exit_handler(void);
+static bool enter_handler_or_request_recheck(void);
+static bool is_handler_running_in_this_context(void);
+static void wake_dispatch_thread(void);
+
+#if defined(__linux__)
+static void *dispatch_thread_main(void *arg);
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                               Private Globals                              */
+/*----------------------------------------------------------------------------*/
+volatile enum handler_dispatch_mode handler_dispatch_mode = HANDLER_DISPATCH_SYNCHRONOUS;
+
+/*
+ * one bit per handler event- w/ coalescing at most one event of each kind can
+ * be pending, so the mask is the whole queue and posting is one fetch_or
+ */
+volatile uint32_t pending_handler_events_mask = 0;
+handler_function volatile pending_handlers_array[HANDLER_EVENTS_COUNT] = {NULL};
+
+volatile uint32_t handler_running_flag = 0;
+volatile uint32_t handler_recheck_requested = 0;
+volatile uint32_t running_handler_event = HANDLER_EVENTS_COUNT;
+volatile uint32_t coalesced_handler_event_count = 0;
+volatile uint32_t suppressed_reentrant_handler_count = 0;
+volatile uint32_t contended_handler_event_count = 0;
+
+#if defined(__linux__)
+/* per thread, so a handler running on another thread isn't taken for re-entrancy */
+__thread bool handler_running_in_thread = false;
+
+/* set on the dispatch thread when a handler stops it, since it can't join itself */
+__thread bool dispatch_thread_stopped_itself = false;
+
+pthread_t dispatch_thread;
+sem_t dispatch_thread_semaphore;
+volatile bool dispatch_thread_running = false;
+enum handler_dispatch_mode mode_before_dispatch_thread = HANDLER_DISPATCH_SYNCHRONOUS;
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+void set_handler_dispatch_mode(enum handler_dispatch_mode mode)
+{
+    RUNTIME_ATOMIC_STORE(&handler_dispatch_mode, mode);
+}
+
+enum handler_dispatch_mode get_handler_dispatch_mode(void)
+{
+    return RUNTIME_ATOMIC_LOAD(&handler_dispatch_mode);
+}
+
+void dispatch_handler(enum handler_event event, void (*handler)(void))
+{
+    if (RUNTIME_ATOMIC_LOAD(&handler_dispatch_mode) == HANDLER_DISPATCH_DEFERRED) {
+        post_handler_event(event, handler);
+        return;
+    }
+
+    /*
+     * a handler raising its own event would loop, so that's dropped- any other
+     * event (e.g. an error raised in the warning handler), or any event raised
+     * while another thread's handler runs, is posted and run once the handler
+     * returns
+     */
+    if (!enter_handler()) {
+        if (!is_handler_running_in_this_context()) {
+            RUNTIME_ATOMIC_FETCH_ADD(&contended_handler_event_count, 1u);
+        } else if (RUNTIME_ATOMIC_LOAD(&running_handler_event) == (uint32_t)event) {
+            RUNTIME_ATOMIC_FETCH_ADD(&suppressed_reentrant_handler_count, 1u);
+            return;
+        }
+        post_handler_event(event, handler);
+        poll_deferred_handlers();
+        return;
+    }
+    call_handler(event, handler);
+    exit_handler();
+    poll_deferred_handlers();
+}
+
+uint32_t poll_deferred_handlers(void)
+{
+    uint32_t handlers_called = 0u;
+
+    /*
+     * a handler that polls leaves the events pending. Another thread finding
+     * the handlers held asks the holder to re-check once it lets go, so its
+     * event isn't left pending
+     */
+    while (RUNTIME_ATOMIC_LOAD(&pending_handler_events_mask) != 0u) {
+        if (!enter_handler_or_request_recheck()) {
+            break;
+        }
+
+        (void)RUNTIME_ATOMIC_EXCHANGE(&handler_recheck_requested, 0u);
+        uint32_t events_mask = RUNTIME_ATOMIC_EXCHANGE(&pending_handler_events_mask, 0u);
+        for (uint32_t i = 0u; i < HANDLER_EVENTS_COUNT; i++) {
+            if ((events_mask & get_handler_event_bit((enum handler_event)i)) != 0u) {
+                handler_function handler = RUNTIME_ATOMIC_LOAD(&pending_handlers_array[i]);
+                call_handler((enum handler_event)i, handler);
+                handlers_called++;
+            }
+        }
+
+        exit_handler();
+        if (RUNTIME_ATOMIC_EXCHANGE(&handler_recheck_requested, 0u) == 0u) {
+            break;
+        }
+    }
+    return handlers_called;
+}
+
+bool is_handler_event_pending(enum handler_event event)
+{
+    return (RUNTIME_ATOMIC_LOAD(&pending_handler_events_mask) & get_handler_event_bit(event)) != 0u;
+}
+
+uint32_t get_coalesced_handler_event_count(void)
+{
+    return RUNTIME_ATOMIC_LOAD(&coalesced_handler_event_count);
+}
+
+uint32_t get_suppressed_reentrant_handler_count(void)
+{
+    return RUNTIME_ATOMIC_LOAD(&suppressed_reentrant_handler_count);
+}
+
+uint32_t get_contended_handler_event_count(void)
+{
+    return RUNTIME_ATOMIC_LOAD(&contended_handler_event_count);
+}
+
+#if defined(__linux__)
+bool start_handler_dispatch_thread(void)
+{
+    if (RUNTIME_ATOMIC_LOAD(&dispatch_thread_running)) {
+        return true;
+    }
+
+    if (sem_init(&dispatch_thread_semaphore, 0, 0) != 0) {
+        return false;
+    }
+
+    mode_before_dispatch_thread = get_handler_dispatch_mode();
+    RUNTIME_ATOMIC_STORE(&dispatch_thread_running, true);
+    if (pthread_create(&dispatch_thread, NULL, dispatch_thread_main, NULL) != 0) {
+        RUNTIME_ATOMIC_STORE(&dispatch_thread_running, false);
+        sem_destroy(&dispatch_thread_semaphore);
+        return false;
+    }
+
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    return true;
+}
+
+void stop_handler_dispatch_thread(void)
+{
+    if (!RUNTIME_ATOMIC_LOAD(&dispatch_thread_running)) {
+        return;
+    }
+
+    RUNTIME_ATOMIC_STORE(&dispatch_thread_running, false);
+    if (pthread_equal(pthread_self(), dispatch_thread)) {
+        /* stopped from one of its handlers (e.g. init_runtime_diagnostics()) */
+        dispatch_thread_stopped_itself = true;
+        pthread_detach(dispatch_thread);
+    } else {
+        sem_post(&dispatch_thread_semaphore);
+        pthread_join(dispatch_thread, NULL);
+    }
+    sem_destroy(&dispatch_thread_semaphore);
+    set_handler_dispatch_mode(mode_before_dispatch_thread);
+}
+#endif
+
+void reset_handler_dispatch(void)
+{
+#if defined(__linux__)
+    stop_handler_dispatch_thread();
+#endif
+    RUNTIME_ATOMIC_STORE(&handler_dispatch_mode, HANDLER_DISPATCH_SYNCHRONOUS);
+    RUNTIME_ATOMIC_STORE(&pending_handler_events_mask, 0u);
+    for (uint32_t i = 0u; i < HANDLER_EVENTS_COUNT; i++) {
+        RUNTIME_ATOMIC_STORE(&pending_handlers_array[i], NULL);
+    }
+    RUNTIME_ATOMIC_STORE(&handler_running_flag, 0u);
+    RUNTIME_ATOMIC_STORE(&handler_recheck_requested, 0u);
+    RUNTIME_ATOMIC_STORE(&running_handler_event, HANDLER_EVENTS_COUNT);
+    RUNTIME_ATOMIC_STORE(&coalesced_handler_event_count, 0u);
+    RUNTIME_ATOMIC_STORE(&suppressed_reentrant_handler_count, 0u);
+    RUNTIME_ATOMIC_STORE(&contended_handler_event_count, 0u);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t get_handler_event_bit(enum handler_event event)
+{
+    return 1u << (uint32_t)event;
+}
+
+static void post_handler_event(enum handler_event event, handler_function handler)
+{
+    RUNTIME_ATOMIC_STORE(&pending_handlers_array[event], handler);
+
+    uint32_t event_bit = get_handler_event_bit(event);
+    uint32_t previous_mask = RUNTIME_ATOMIC_FETCH_OR(&pending_handler_events_mask, event_bit);
+    if ((previous_mask & event_bit) != 0u) {
+        RUNTIME_ATOMIC_FETCH_ADD(&coalesced_handler_event_count, 1u);
+        return;
+    }
+
+    wake_dispatch_thread();
+}
+
+static void call_handler(enum handler_event event, handler_function handler)
+{
+    RUNTIME_ATOMIC_STORE(&running_handler_event, (uint32_t)event);
+    START_PROFILING_SAMPLE(start_cycles);
+    handler();
+    END_PROFILING_SAMPLE((event == WARNING_HANDLER_EVENT) ? WARNING_HANDLER_PROFILING_PROBE
+                                                          : ERROR_HANDLER_PROFILING_PROBE,
+                         start_cycles);
+}
+
+static bool enter_handler(void)
+{
+    if (RUNTIME_ATOMIC_EXCHANGE(&handler_running_flag, 1u) != 0u) {
+        return false;
+    }
+#if defined(__linux__)
+    handler_running_in_thread = true;
+#endif
+    return true;
+}
+
+static void exit_handler(void)
+{
+#if defined(__linux__)
+    handler_running_in_thread = false;
+#endif
+    RUNTIME_ATOMIC_STORE(&running_handler_event, HANDLER_EVENTS_COUNT);
+    /*
+     * an exchange rather than a store- it reads a failed enter's write, so a
+     * recheck requested before that enter is visible to the holder
+     */
+    (void)RUNTIME_ATOMIC_EXCHANGE(&handler_running_flag, 0u);
+}
+
+static bool enter_handler_or_request_recheck(void)
+{
+    if (enter_handler()) {
+        return true;
+    }
+
+    /* nested in our own handler- re-checking could loop between handlers */
+    if (is_handler_running_in_this_context()) {
+        return false;
+    }
+
+    /* the holder either sees the request after letting go, or has let go already */
+    RUNTIME_ATOMIC_STORE(&handler_recheck_requested, 1u);
+    return enter_handler();
+}
+
+static bool is_handler_running_in_this_context(void)
+{
+#if defined(__linux__)
+    return handler_running_in_thread;
+#else
+    /* single context (main loop + interrupts)- the handler held is our own caller's */
+    return true;
+#endif
+}
+
+static void wake_dispatch_thread(void)
+{
+#if defined(__linux__)
+    if (RUNTIME_ATOMIC_LOAD(&dispatch_thread_running)) {
+        sem_post(&dispatch_thread_semaphore);
+    }
+#endif
+}
+
+#if defined(__linux__)
+static void *dispatch_thread_main(void *arg)
+{
+    (void)arg;
+
+    /* a new dispatch thread may be started before this one exits after stopping itself */
+    while (RUNTIME_ATOMIC_LOAD(&dispatch_thread_running) && !dispatch_thread_stopped_itself) {
+        if (sem_wait(&dispatch_thread_semaphore) != 0 && errno == EINTR) {
+            continue;
+        }
+        poll_deferred_handlers();
+    }
+
+    /* service anything posted between the last wakeup and stop */
+    poll_deferred_handlers();
+    return NULL;
+}
+#endif
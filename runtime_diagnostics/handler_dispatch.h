@@ -0,0 +1,58 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : handler_dispatch.h                                    */
+/*                                                                            */
+/* Interface to synchronous or deferred dispatch of user handlers             */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef HANDLER_DISPATCH_H_
+#define HANDLER_DISPATCH_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum handler_dispatch_mode
+{
+    HANDLER_DISPATCH_SYNCHRONOUS = 0,
+    HANDLER_DISPATCH_DEFERRED
+};
+
+enum handler_event
+{
+    WARNING_HANDLER_EVENT = 0,
+    ERROR_HANDLER_EVENT,
+    HANDLER_EVENTS_COUNT
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+void set_handler_dispatch_mode(enum handler_dispatch_mode mode);
+enum handler_dispatch_mode get_handler_dispatch_mode(void);
+
+/* runs handler now, or posts it for poll_deferred_handlers() when deferred */
+void dispatch_handler(enum handler_event event, void (*handler)(void));
+uint32_t poll_deferred_handlers(void);
+bool is_handler_event_pending(enum handler_event event);
+
+uint32_t get_coalesced_handler_event_count(void);
+uint32_t get_suppressed_reentrant_handler_count(void);
+/* events raised while another thread's handler ran (linux)- they run once it returns */
+uint32_t get_contended_handler_event_count(void);
+
+#if defined(__linux__)
+/* services deferred handlers from a dedicated thread (sets deferred mode until stopped) */
+bool start_handler_dispatch_thread(void);
+/* joins the thread- from one of its own handlers, it's detached and exits once that returns */
+void stop_handler_dispatch_thread(void);
+#endif
+
+/* reset is for testing only */
+void reset_handler_dispatch(void);
+
+#endif /* HANDLER_DISPATCH_H_ */
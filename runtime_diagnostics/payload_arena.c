@@ -0,0 +1,130 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : payload_arena.c                                       */
+/*                                                                            */
+/* A byte ring of length-prefixed records- records may wrap the ring's end    */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "payload_arena.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t wrap_offset(const struct payload_arena *arena, uint32_t offset);
+static void write_wrapped(struct payload_arena *arena, uint32_t offset, const void *source,
+                          uint32_t size);
+static void read_wrapped(const struct payload_arena *arena, uint32_t offset, void *destination,
+                         uint32_t size);
+static uint16_t read_record_length(const struct payload_arena *arena, uint32_t offset);
+static void drop_oldest_record(struct payload_arena *arena);
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+void reset_payload_arena(struct payload_arena *arena)
+{
+    memset(arena->bytes, 0, arena->capacity);
+    arena->head = 0;
+    arena->tail = 0;
+    arena->used_size = 0;
+    arena->record_count = 0;
+}
+
+bool append_payload_arena_record(struct payload_arena *arena, const void *header,
+                                 uint32_t header_size, const void *payload,
+                                 uint32_t payload_size)
+{
+    uint32_t record_length = header_size + payload_size;
+    uint32_t total_size = PAYLOAD_ARENA_LENGTH_PREFIX_SIZE + record_length;
+    if ((record_length > UINT16_MAX) || (total_size > arena->capacity)) {
+        return false;
+    }
+
+    while ((arena->capacity - arena->used_size) < total_size) {
+        drop_oldest_record(arena);
+    }
+
+    uint16_t length_prefix = (uint16_t)record_length;
+    uint32_t offset = arena->head;
+    write_wrapped(arena, offset, &length_prefix, PAYLOAD_ARENA_LENGTH_PREFIX_SIZE);
+    offset = wrap_offset(arena, offset + PAYLOAD_ARENA_LENGTH_PREFIX_SIZE);
+    write_wrapped(arena, offset, header, header_size);
+    offset = wrap_offset(arena, offset + header_size);
+    write_wrapped(arena, offset, payload, payload_size);
+
+    arena->head = wrap_offset(arena, arena->head + total_size);
+    arena->used_size += total_size;
+    arena->record_count++;
+    return true;
+}
+
+uint32_t read_payload_arena_record(const struct payload_arena *arena, uint32_t *offset,
+                                   void *record, uint32_t record_capacity)
+{
+    uint32_t record_length = read_record_length(arena, *offset);
+    uint32_t record_offset = wrap_offset(arena, *offset + PAYLOAD_ARENA_LENGTH_PREFIX_SIZE);
+    uint32_t copy_size = (record_length < record_capacity) ? record_length : record_capacity;
+
+    read_wrapped(arena, record_offset, record, copy_size);
+    *offset = wrap_offset(arena, record_offset + record_length);
+    return record_length;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t wrap_offset(const struct payload_arena *arena, uint32_t offset)
+{
+    return offset % arena->capacity;
+}
+
+static void write_wrapped(struct payload_arena *arena, uint32_t offset, const void *source,
+                          uint32_t size)
+{
+    if (size == 0u) {
+        return;
+    }
+
+    uint32_t first_part_size = arena->capacity - offset;
+    if (size <= first_part_size) {
+        memcpy(&arena->bytes[offset], source, size);
+        return;
+    }
+
+    memcpy(&arena->bytes[offset], source, first_part_size);
+    memcpy(arena->bytes, (const uint8_t *)source + first_part_size, size - first_part_size);
+}
+
+static void read_wrapped(const struct payload_arena *arena, uint32_t offset, void *destination,
+                         uint32_t size)
+{
+    uint32_t first_part_size = arena->capacity - offset;
+    if (size <= first_part_size) {
+        memcpy(destination, &arena->bytes[offset], size);
+        return;
+    }
+
+    memcpy(destination, &arena->bytes[offset], first_part_size);
+    memcpy((uint8_t *)destination + first_part_size, arena->bytes, size - first_part_size);
+}
+
+static uint16_t read_record_length(const struct payload_arena *arena, uint32_t offset)
+{
+    uint16_t record_length = 0;
+    read_wrapped(arena, offset, &record_length, PAYLOAD_ARENA_LENGTH_PREFIX_SIZE);
+    return record_length;
+}
+
+static void drop_oldest_record(struct payload_arena *arena)
+{
+    uint32_t total_size = PAYLOAD_ARENA_LENGTH_PREFIX_SIZE + read_record_length(arena, arena->tail);
+    arena->tail = wrap_offset(arena, arena->tail + total_size);
+    arena->used_size -= total_size;
+    arena->record_count--;
+}
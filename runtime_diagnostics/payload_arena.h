@@ -0,0 +1,51 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : payload_arena.h                                       */
+/*                                                                            */
+/* Interface to a byte ring of length-prefixed, variable-length records       */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef PAYLOAD_ARENA_H_
+#define PAYLOAD_ARENA_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    PAYLOAD_ARENA_LENGTH_PREFIX_SIZE = sizeof(uint16_t)
+};
+
+struct payload_arena {
+    uint8_t *bytes;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t used_size;
+    uint32_t record_count;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+void reset_payload_arena(struct payload_arena *arena);
+
+/* oldest records are dropped to make room- false if the record can never fit */
+bool append_payload_arena_record(struct payload_arena *arena, const void *header,
+                                 uint32_t header_size, const void *payload,
+                                 uint32_t payload_size);
+
+/*
+ * copies the record at *offset into record (up to record_capacity bytes),
+ * advances *offset to the next record and returns the full record length.
+ * Start iterating at arena->tail, for arena->record_count records
+ */
+uint32_t read_payload_arena_record(const struct payload_arena *arena, uint32_t *offset,
+                                   void *record, uint32_t record_capacity);
+
+#endif /* PAYLOAD_ARENA_H_ */
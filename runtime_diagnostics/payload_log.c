@@ -0,0 +1,111 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : payload_log.c                                         */
+/*                                                                            */
+/* Log of entries w/ variable-length payloads, kept in a payload arena        */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "payload_arena.h"
+#include "payload_log.h"
+#include "payload_log_records.h"
+#include "self_profiling_probes.h"
+
+/*----------------------------------------------------------------------------*/
+/*                           Struct, Enum, Typedefs                           */
+/*----------------------------------------------------------------------------*/
+struct payload_record_header {
+    uint32_t timestamp;
+    const char *fail_message;
+    uint8_t log;
+    uint8_t payload_size;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static void printf_payload_as_hex(const uint8_t *payload, uint32_t payload_size);
+
+/*----------------------------------------------------------------------------*/
+/*                               Private Globals                              */
+/*----------------------------------------------------------------------------*/
+uint8_t payload_log_bytes[PAYLOAD_LOG_CAPACITY_BYTES] = {0};
+struct payload_arena payload_log_arena = {payload_log_bytes, PAYLOAD_LOG_CAPACITY_BYTES,
+                                          0, 0, 0, 0};
+
+void (*payload_formatter)(const uint8_t *payload, uint32_t payload_size) = printf_payload_as_hex;
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+uint32_t add_payload_log_record(enum runtime_log log, uint32_t timestamp,
+                                const char *fail_message, const void *payload,
+                                uint32_t payload_size)
+{
+    if (payload_size > PAYLOAD_MAX_SIZE) {
+        payload_size = PAYLOAD_MAX_SIZE;
+    }
+
+    struct payload_record_header header;
+    memset(&header, 0, sizeof(header));
+    header.timestamp = timestamp;
+    header.fail_message = fail_message;
+    header.log = (uint8_t)log;
+    header.payload_size = (uint8_t)payload_size;
+
+    /* header and payload go in as one record, so they can't be split up */
+    append_payload_arena_record(&payload_log_arena, &header, sizeof(header), payload,
+                                payload_size);
+    return payload_size;
+}
+
+void set_payload_formatter(void (*formatter)(const uint8_t *payload, uint32_t payload_size))
+{
+    payload_formatter = (formatter != NULL) ? formatter : printf_payload_as_hex;
+}
+
+uint32_t get_payload_log_current_size(void)
+{
+    return payload_log_arena.record_count;
+}
+
+void printf_payload_log(void)
+{
+    START_PROFILING_SAMPLE(start_cycles);
+    uint8_t record[sizeof(struct payload_record_header) + PAYLOAD_MAX_SIZE];
+    struct payload_record_header header;
+    uint32_t offset = payload_log_arena.tail;
+
+    for (uint32_t i = 0u; i < payload_log_arena.record_count; i++) {
+        read_payload_arena_record(&payload_log_arena, &offset, record, sizeof(record));
+        memcpy(&header, record, sizeof(header));
+
+        printf("%s %" PRIu32 " %s ", log_names_array[header.log],
+               header.timestamp, header.fail_message);
+        payload_formatter(&record[sizeof(header)], header.payload_size);
+        printf("\r\n");
+    }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
+}
+
+void reset_payload_log(void)
+{
+    reset_payload_arena(&payload_log_arena);
+    payload_formatter = printf_payload_as_hex;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static void printf_payload_as_hex(const uint8_t *payload, uint32_t payload_size)
+{
+    for (uint32_t i = 0u; i < payload_size; i++) {
+        printf("%s%02" PRIX8, (i == 0u) ? "" : " ", payload[i]);
+    }
+}
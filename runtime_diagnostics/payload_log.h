@@ -0,0 +1,35 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : payload_log.h                                         */
+/*                                                                            */
+/* Interface to runtime logging w/ small variable-length binary payloads      */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef PAYLOAD_LOG_H_
+#define PAYLOAD_LOG_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    PAYLOAD_LOG_CAPACITY_BYTES = 512,
+    PAYLOAD_MAX_SIZE = 32
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+void set_payload_formatter(void (*formatter)(const uint8_t *payload, uint32_t payload_size));
+
+uint32_t get_payload_log_current_size(void);
+void printf_payload_log(void);
+
+/* reset is for testing only */
+void reset_payload_log(void);
+
+#endif /* PAYLOAD_LOG_H_ */
@@ -0,0 +1,34 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : payload_log_records.h                                 */
+/*                                                                            */
+/* Payload records added by the RUNTIME_*_PAYLOAD functions (private header)  */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef PAYLOAD_LOG_RECORDS_H_
+#define PAYLOAD_LOG_RECORDS_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "runtime_diagnostics.h"
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+/* indexed by enum runtime_log- defined in runtime_diagnostics.c */
+extern const char *log_names_array[];
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+/*
+ * the RUNTIME_*_PAYLOAD functions add the record, then log the call like any
+ * other RUNTIME_* call. Payloads longer than PAYLOAD_MAX_SIZE bytes are
+ * truncated- returns the payload size that was stored
+ */
+uint32_t add_payload_log_record(enum runtime_log log, uint32_t timestamp,
+                                const char *fail_message, const void *payload,
+                                uint32_t payload_size);
+
+#endif /* PAYLOAD_LOG_RECORDS_H_ */
@@ -0,0 +1,96 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : running_statistics.c                                  */
+/*                                                                            */
+/* Running event rate and fail_value statistics w/ O(1) updates (Welford)     */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "running_statistics.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static void update_event_rate_window(struct running_statistics *stats, uint32_t timestamp);
+static void update_fail_value_statistics(struct running_statistics *stats, uint32_t fail_value);
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+void reset_running_statistics(struct running_statistics *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+void update_running_statistics(struct running_statistics *stats, uint32_t timestamp,
+                               uint32_t fail_value)
+{
+    update_event_rate_window(stats, timestamp);
+    update_fail_value_statistics(stats, fail_value);
+}
+
+double get_running_statistics_variance(const struct running_statistics *stats)
+{
+    if (stats->event_count == 0u) {
+        return 0.0;
+    }
+    return stats->sum_of_squared_deviations / (double)stats->event_count;
+}
+
+void printf_running_statistics(const char *name, const struct running_statistics *stats)
+{
+    printf("%s: count %" PRIu32 ", last window %" PRIu32 ", current window %" PRIu32
+           ", min %" PRIu32 ", max %" PRIu32 ", mean %.2f, variance %.2f\r\n",
+           name, stats->event_count, stats->last_window_event_count,
+           stats->current_window_event_count, stats->min_fail_value, stats->max_fail_value,
+           stats->mean_fail_value, get_running_statistics_variance(stats));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static void update_event_rate_window(struct running_statistics *stats, uint32_t timestamp)
+{
+    if (stats->event_count == 0u) {
+        stats->window_start = timestamp;
+    }
+
+    /*
+     * unsigned subtraction keeps this correct across timestamp wraparound. Late
+     * timestamps (e.g. from an ISR, another producer, or a handler logging 0)
+     * are counted in the current window rather than read as a jump forward
+     */
+    uint32_t elapsed = timestamp - stats->window_start;
+    if ((int32_t)elapsed >= (int32_t)RUNNING_STATISTICS_WINDOW_LENGTH) {
+        uint32_t windows_passed = elapsed / RUNNING_STATISTICS_WINDOW_LENGTH;
+        stats->last_window_event_count = (windows_passed == 1u)
+                                                 ? stats->current_window_event_count
+                                                 : 0u;
+        stats->current_window_event_count = 0u;
+        stats->window_start += windows_passed * RUNNING_STATISTICS_WINDOW_LENGTH;
+    }
+    stats->current_window_event_count++;
+}
+
+static void update_fail_value_statistics(struct running_statistics *stats, uint32_t fail_value)
+{
+    if (stats->event_count == 0u) {
+        stats->min_fail_value = fail_value;
+        stats->max_fail_value = fail_value;
+    } else if (fail_value < stats->min_fail_value) {
+        stats->min_fail_value = fail_value;
+    } else if (fail_value > stats->max_fail_value) {
+        stats->max_fail_value = fail_value;
+    }
+
+    stats->event_count++;
+    double delta = (double)fail_value - stats->mean_fail_value;
+    stats->mean_fail_value += delta / (double)stats->event_count;
+    stats->sum_of_squared_deviations += delta * ((double)fail_value - stats->mean_fail_value);
+}
@@ -0,0 +1,45 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : running_statistics.h                                  */
+/*                                                                            */
+/* Interface to O(1) running statistics of runtime log calls                  */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef RUNNING_STATISTICS_H_
+#define RUNNING_STATISTICS_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    /* length of an event rate window, in the same units as log timestamps */
+    RUNNING_STATISTICS_WINDOW_LENGTH = 1000
+};
+
+struct running_statistics {
+    uint32_t event_count;
+    uint32_t window_start;
+    uint32_t current_window_event_count;
+    uint32_t last_window_event_count;
+    uint32_t min_fail_value;
+    uint32_t max_fail_value;
+    /* double- a float's 24 bit mantissa can't hold e.g. an address or timestamp fail_value */
+    double mean_fail_value;
+    double sum_of_squared_deviations;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+void reset_running_statistics(struct running_statistics *stats);
+void update_running_statistics(struct running_statistics *stats, uint32_t timestamp,
+                               uint32_t fail_value);
+double get_running_statistics_variance(const struct running_statistics *stats);
+void printf_running_statistics(const char *name, const struct running_statistics *stats);
+
+#endif /* RUNNING_STATISTICS_H_ */
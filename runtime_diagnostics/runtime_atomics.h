@@ -0,0 +1,127 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_atomics.h                                     */
+/*                                                                            */
+/* Word-sized atomics for toolchains w/ and w/o C11 atomics (private header)  */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef RUNTIME_ATOMICS_H_
+#define RUNTIME_ATOMICS_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+
+#if !defined(__ATOMIC_ACQ_REL) && defined(_MSC_VER)
+#include <intrin.h>
+#elif !defined(__ATOMIC_ACQ_REL) && defined(__AVR32__)
+#include <avr32/io.h>
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+/*
+ * objects are plain volatile words (or pointers)- loads and stores can be done
+ * directly, read-modify-writes go through the builtins below. LOAD is acquire,
+ * STORE is release, and the read-modify-writes are acquire/release
+ */
+#if defined(__ATOMIC_ACQ_REL)
+/* gcc 4.7+ and clang */
+#define RUNTIME_ATOMIC_LOAD(object) __atomic_load_n((object), __ATOMIC_ACQUIRE)
+#define RUNTIME_ATOMIC_STORE(object, value) __atomic_store_n((object), (value), __ATOMIC_RELEASE)
+#define RUNTIME_ATOMIC_EXCHANGE(object, value) \
+    __atomic_exchange_n((object), (value), __ATOMIC_ACQ_REL)
+#define RUNTIME_ATOMIC_FETCH_OR(object, value) \
+    __atomic_fetch_or((object), (value), __ATOMIC_ACQ_REL)
+#define RUNTIME_ATOMIC_FETCH_AND(object, value) \
+    __atomic_fetch_and((object), (value), __ATOMIC_ACQ_REL)
+#define RUNTIME_ATOMIC_FETCH_ADD(object, value) \
+    __atomic_fetch_add((object), (value), __ATOMIC_ACQ_REL)
+
+#elif defined(_MSC_VER)
+/* volatile accesses are acquire/release on msvc (/volatile:ms, the x86/x64 default) */
+#define RUNTIME_ATOMIC_LOAD(object) (*(object))
+#define RUNTIME_ATOMIC_STORE(object, value) (*(object) = (value))
+#define RUNTIME_ATOMIC_EXCHANGE(object, value) \
+    ((uint32_t)_InterlockedExchange((volatile long *)(object), (long)(value)))
+#define RUNTIME_ATOMIC_FETCH_OR(object, value) \
+    ((uint32_t)_InterlockedOr((volatile long *)(object), (long)(value)))
+#define RUNTIME_ATOMIC_FETCH_AND(object, value) \
+    ((uint32_t)_InterlockedAnd((volatile long *)(object), (long)(value)))
+#define RUNTIME_ATOMIC_FETCH_ADD(object, value) \
+    ((uint32_t)_InterlockedExchangeAdd((volatile long *)(object), (long)(value)))
+
+#else
+/*
+ * single core mcus (e.g. the 4.4 era avr32-gcc)- word loads and stores are
+ * single instructions, read-modify-writes run w/ interrupts masked. Define
+ * both macros to use an RTOS's critical section instead
+ */
+#if !defined(RUNTIME_DIAGNOSTICS_ENTER_CRITICAL) || !defined(RUNTIME_DIAGNOSTICS_EXIT_CRITICAL)
+#if defined(__AVR32__)
+#define RUNTIME_DIAGNOSTICS_ENTER_CRITICAL(saved_state)      \
+    do {                                                     \
+        (saved_state) = (uint32_t)__builtin_mfsr(AVR32_SR);  \
+        __builtin_ssrf(AVR32_SR_GM_OFFSET);                  \
+    } while (0)
+#define RUNTIME_DIAGNOSTICS_EXIT_CRITICAL(saved_state)       \
+    do {                                                     \
+        if (((saved_state) & AVR32_SR_GM_MASK) == 0u) {      \
+            __builtin_csrf(AVR32_SR_GM_OFFSET);              \
+        }                                                    \
+    } while (0)
+#else
+#error "define RUNTIME_DIAGNOSTICS_ENTER_CRITICAL and RUNTIME_DIAGNOSTICS_EXIT_CRITICAL"
+#endif
+#endif
+
+#define RUNTIME_ATOMIC_LOAD(object) (*(object))
+#define RUNTIME_ATOMIC_STORE(object, value) (*(object) = (value))
+#define RUNTIME_ATOMIC_EXCHANGE(object, value) runtime_atomic_exchange((object), (value))
+#define RUNTIME_ATOMIC_FETCH_OR(object, value) runtime_atomic_fetch_or((object), (value))
+#define RUNTIME_ATOMIC_FETCH_AND(object, value) runtime_atomic_fetch_and((object), (value))
+#define RUNTIME_ATOMIC_FETCH_ADD(object, value) runtime_atomic_fetch_add((object), (value))
+
+static inline uint32_t runtime_atomic_exchange(volatile uint32_t *object, uint32_t value)
+{
+    uint32_t saved_state;
+    RUNTIME_DIAGNOSTICS_ENTER_CRITICAL(saved_state);
+    uint32_t previous = *object;
+    *object = value;
+    RUNTIME_DIAGNOSTICS_EXIT_CRITICAL(saved_state);
+    return previous;
+}
+
+static inline uint32_t runtime_atomic_fetch_or(volatile uint32_t *object, uint32_t value)
+{
+    uint32_t saved_state;
+    RUNTIME_DIAGNOSTICS_ENTER_CRITICAL(saved_state);
+    uint32_t previous = *object;
+    *object = previous | value;
+    RUNTIME_DIAGNOSTICS_EXIT_CRITICAL(saved_state);
+    return previous;
+}
+
+static inline uint32_t runtime_atomic_fetch_and(volatile uint32_t *object, uint32_t value)
+{
+    uint32_t saved_state;
+    RUNTIME_DIAGNOSTICS_ENTER_CRITICAL(saved_state);
+    uint32_t previous = *object;
+    *object = previous & value;
+    RUNTIME_DIAGNOSTICS_EXIT_CRITICAL(saved_state);
+    return previous;
+}
+
+static inline uint32_t runtime_atomic_fetch_add(volatile uint32_t *object, uint32_t value)
+{
+    uint32_t saved_state;
+    RUNTIME_DIAGNOSTICS_ENTER_CRITICAL(saved_state);
+    uint32_t previous = *object;
+    *object = previous + value;
+    RUNTIME_DIAGNOSTICS_EXIT_CRITICAL(saved_state);
+    return previous;
+}
+#endif
+
+#endif /* RUNTIME_ATOMICS_H_ */
@@ -13,17 +13,33 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "runtime_atomics.h"
+#include "payload_log_records.h"
 #include "runtime_diagnostics.h"
+#include "self_profiling_probes.h"
+#if defined(RUNTIME_DIAGNOSTICS_EXPORTER)
+#include "runtime_exporter.h"
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+/* the caller's return address is a register read- an inlined RUNTIME_* would report its caller's */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CALLER_ADDRESS() ((uintptr_t)_ReturnAddress())
+#define RECORDS_CALL_SITE __declspec(noinline)
+#else
+#define CALLER_ADDRESS() ((uintptr_t)__builtin_return_address(0))
+#define RECORDS_CALL_SITE __attribute__((noinline))
+#endif
+#define SAVE_CALL_SITE(log_index) save_call_site((log_index), CALLER_ADDRESS())
+#else
+#define RECORDS_CALL_SITE
+#define SAVE_CALL_SITE(log_index)
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*                           Struct, Enum, Typedefs                           */
 /*----------------------------------------------------------------------------*/
-struct log_entry {
-    uint32_t timestamp;
-    const char *fail_message;
-    uint32_t fail_value;
-};
-
 struct circular_buffer {
     struct log_entry *log_entries;
     uint32_t log_capacity;
@@ -31,6 +47,13 @@ struct circular_buffer {
     uint32_t current_size;
 };
 
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+struct call_site_statistics {
+    const char *fail_message;
+    struct running_statistics stats;
+};
+#endif
+
 enum log_category
 {
     TELEMETRY_LOG_INDEX = 0,
@@ -39,10 +62,23 @@ enum log_category
     LOG_CATEGORIES_COUNT
 };
 
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+enum capture_state
+{
+    CAPTURE_ARMED = 0,
+    CAPTURE_RECORDING,
+    CAPTURE_COMPLETE
+};
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                         Private Function Prototypes                        */
 /*----------------------------------------------------------------------------*/
 static void reset_runtime_diagnostics_state(void);
+static uint32_t get_subsystem_bit(uint32_t subsystem);
+static void log_telemetry_entry(struct log_entry new_entry);
+static void log_warning_entry(struct log_entry new_entry);
+static void log_error_entry(struct log_entry new_entry);
 static struct log_entry create_log_entry(uint32_t timestamp, const char *fail_message,
                                          uint32_t fail_value);
 static void add_entry_to_circular_buffer(enum log_category log_index, struct log_entry new_entry);
@@ -56,8 +92,37 @@ static void reset_log_entries(struct log_entry *entries, uint32_t entries_count)
 static void reset_circular_buffer(enum log_category log_index);
 static void reset_all_circular_buffers(void);
 static struct log_entry get_entry_at_index(enum log_category log_index, uint32_t entry_index);
+static struct log_entry get_circular_buffer_entry(const struct circular_buffer *target_cb,
+                                                  uint32_t entry_index);
+static uint32_t get_buffer_index(const struct circular_buffer *target_cb, uint32_t entry_index);
+static struct log_entry get_log_entry_if_present(enum log_category log_index,
+                                                 uint32_t entry_index);
 static void print_log_entry(struct log_entry entry);
 static void printf_log(enum log_category log_index);
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+static void reset_all_statistics(void);
+static void update_log_statistics(enum log_category log_index, struct log_entry new_entry);
+static uint32_t hash_call_site(const char *fail_message);
+static struct call_site_statistics *find_call_site(const char *fail_message, bool add_if_missing);
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+static void reset_capture(void);
+static void update_capture(enum log_category log_index, struct log_entry new_entry);
+static bool is_capture_trigger(enum log_category log_index, struct log_entry new_entry);
+static void freeze_all_circular_buffers(void);
+static uint32_t get_captured_log_size(enum log_category log_index);
+static struct log_entry get_captured_log_entry_if_present(enum log_category log_index,
+                                                          uint32_t entry_index);
+static void print_captured_log_entry(struct captured_log_entry captured);
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+static void save_call_site(enum log_category log_index, uintptr_t call_site);
+static uintptr_t get_call_site_if_present(enum log_category log_index, uint32_t entry_index);
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW) && defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+static uintptr_t get_captured_call_site_if_present(enum log_category log_index,
+                                                   uint32_t entry_index);
+#endif
 
 /*----------------------------------------------------------------------------*/
 /*                               Private Globals                              */
@@ -80,6 +145,55 @@ struct circular_buffer *circular_buffer_array[LOG_CATEGORIES_COUNT] = {&telemetr
 
 uint32_t call_counts_array[LOG_CATEGORIES_COUNT] = {0};
 
+/* read inline by the RUNTIME_*_TAGGED macros- flipping bits needs no other sync */
+volatile uint32_t runtime_subsystem_enable_mask = ALL_SUBSYSTEMS_ENABLED;
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+/* parallel to the entry arrays, so struct log_entry keeps its layout */
+uintptr_t telemetry_call_sites[TELEMETRY_LOG_CAPACITY] = {0};
+uintptr_t warning_call_sites[WARNING_LOG_CAPACITY] = {0};
+uintptr_t error_call_sites[ERROR_LOG_CAPACITY] = {0};
+
+uintptr_t *call_sites_array[LOG_CATEGORIES_COUNT] = {telemetry_call_sites, warning_call_sites,
+                                                     error_call_sites};
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+struct log_entry captured_telemetry_entries[TELEMETRY_LOG_CAPACITY] = {{0}};
+struct log_entry captured_warning_entries[WARNING_LOG_CAPACITY] = {{0}};
+struct log_entry captured_error_entries[ERROR_LOG_CAPACITY] = {{0}};
+
+struct circular_buffer captured_telemetry_cb = {captured_telemetry_entries, TELEMETRY_LOG_CAPACITY,
+                                                0, 0};
+struct circular_buffer captured_warning_cb = {captured_warning_entries, WARNING_LOG_CAPACITY, 0,
+                                              0};
+struct circular_buffer captured_error_cb = {captured_error_entries, ERROR_LOG_CAPACITY, 0, 0};
+
+struct circular_buffer *captured_circular_buffer_array[LOG_CATEGORIES_COUNT] = {
+        &captured_telemetry_cb, &captured_warning_cb, &captured_error_cb};
+
+enum capture_state capture_state = CAPTURE_ARMED;
+bool (*user_capture_trigger)(enum runtime_log log, struct log_entry entry) = NULL;
+struct captured_log_entry capture_trigger_entry = {0};
+struct captured_log_entry post_trigger_entries[POST_TRIGGER_CAPTURE_CAPACITY] = {{0}};
+uint32_t post_trigger_capture_size = 0;
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW) && defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+uintptr_t captured_telemetry_call_sites[TELEMETRY_LOG_CAPACITY] = {0};
+uintptr_t captured_warning_call_sites[WARNING_LOG_CAPACITY] = {0};
+uintptr_t captured_error_call_sites[ERROR_LOG_CAPACITY] = {0};
+
+uintptr_t *captured_call_sites_array[LOG_CATEGORIES_COUNT] = {
+        captured_telemetry_call_sites, captured_warning_call_sites, captured_error_call_sites};
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+struct running_statistics statistics_array[LOG_CATEGORIES_COUNT] = {{0}};
+struct call_site_statistics call_site_statistics_array[CALL_SITE_STATISTICS_CAPACITY] = {{0}};
+uint32_t untracked_call_site_event_count = 0;
+#endif
+
 volatile bool runtime_error_asserted = false;
 struct log_entry first_runtime_error_cause = {0};
 bool user_warning_handler_set = false;
@@ -90,30 +204,75 @@ void (*user_error_handler)(void) = NULL;
 /*----------------------------------------------------------------------------*/
 /*                         Public Function Definitions                        */
 /*----------------------------------------------------------------------------*/
+RECORDS_CALL_SITE
 void RUNTIME_TELEMETRY(uint32_t timestamp, const char *fail_message, uint32_t fail_value)
 {
-    add_entry_to_circular_buffer(TELEMETRY_LOG_INDEX,
-                                 create_log_entry(timestamp, fail_message, fail_value));
+    SAVE_CALL_SITE(TELEMETRY_LOG_INDEX);
+    log_telemetry_entry(create_log_entry(timestamp, fail_message, fail_value));
 }
 
+RECORDS_CALL_SITE
 void RUNTIME_WARNING(uint32_t timestamp, const char *fail_message, uint32_t fail_value)
 {
-    struct log_entry new_entry = create_log_entry(timestamp, fail_message, fail_value);
-    add_entry_to_circular_buffer(WARNING_LOG_INDEX, new_entry);
-
-    if (is_log_full(WARNING_LOG_INDEX)) {
-        call_warning_handler_if_set();
-    }
+    SAVE_CALL_SITE(WARNING_LOG_INDEX);
+    log_warning_entry(create_log_entry(timestamp, fail_message, fail_value));
 }
 
+RECORDS_CALL_SITE
 void RUNTIME_ERROR(uint32_t timestamp, const char *fail_message, uint32_t fail_value)
 {
-    struct log_entry new_entry = create_log_entry(timestamp, fail_message, fail_value);
-    add_entry_to_circular_buffer(ERROR_LOG_INDEX, new_entry);
+    SAVE_CALL_SITE(ERROR_LOG_INDEX);
+    log_error_entry(create_log_entry(timestamp, fail_message, fail_value));
+}
 
-    save_entry_if_first_runtime_error(new_entry);
-    assert_runtime_error_flag();
-    call_error_handler_if_set();
+RECORDS_CALL_SITE
+void RUNTIME_TELEMETRY_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                               uint32_t payload_size)
+{
+    uint32_t stored_size =
+            add_payload_log_record(TELEMETRY_LOG, timestamp, fail_message, payload, payload_size);
+    SAVE_CALL_SITE(TELEMETRY_LOG_INDEX);
+    log_telemetry_entry(create_log_entry(timestamp, fail_message, stored_size));
+}
+
+RECORDS_CALL_SITE
+void RUNTIME_WARNING_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                             uint32_t payload_size)
+{
+    uint32_t stored_size =
+            add_payload_log_record(WARNING_LOG, timestamp, fail_message, payload, payload_size);
+    SAVE_CALL_SITE(WARNING_LOG_INDEX);
+    log_warning_entry(create_log_entry(timestamp, fail_message, stored_size));
+}
+
+RECORDS_CALL_SITE
+void RUNTIME_ERROR_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                           uint32_t payload_size)
+{
+    uint32_t stored_size =
+            add_payload_log_record(ERROR_LOG, timestamp, fail_message, payload, payload_size);
+    SAVE_CALL_SITE(ERROR_LOG_INDEX);
+    log_error_entry(create_log_entry(timestamp, fail_message, stored_size));
+}
+
+void set_subsystem_enable_mask(uint32_t mask)
+{
+    RUNTIME_ATOMIC_STORE(&runtime_subsystem_enable_mask, mask);
+}
+
+uint32_t get_subsystem_enable_mask(void)
+{
+    return RUNTIME_ATOMIC_LOAD(&runtime_subsystem_enable_mask);
+}
+
+void enable_subsystem(uint32_t subsystem)
+{
+    RUNTIME_ATOMIC_FETCH_OR(&runtime_subsystem_enable_mask, get_subsystem_bit(subsystem));
+}
+
+void disable_subsystem(uint32_t subsystem)
+{
+    RUNTIME_ATOMIC_FETCH_AND(&runtime_subsystem_enable_mask, ~get_subsystem_bit(subsystem));
 }
 
 void set_warning_handler(void (*handler)(void))
@@ -122,7 +281,7 @@ void set_warning_handler(void (*handler)(void))
     user_warning_handler_set = true;
 
     if (is_log_full(WARNING_LOG_INDEX)) {
-        user_warning_handler();
+        dispatch_handler(WARNING_HANDLER_EVENT, user_warning_handler);
     }
 }
 
@@ -132,7 +291,7 @@ void set_error_handler(void (*handler)(void))
     user_error_handler_set = true;
 
     if (runtime_error_asserted) {
-        user_error_handler();
+        dispatch_handler(ERROR_HANDLER_EVENT, user_error_handler);
     }
 }
 
@@ -151,6 +310,36 @@ uint32_t get_error_log_current_size(void)
     return get_current_size_of_log(ERROR_LOG_INDEX);
 }
 
+struct log_entry get_telemetry_log_entry(uint32_t entry_index)
+{
+    return get_log_entry_if_present(TELEMETRY_LOG_INDEX, entry_index);
+}
+
+struct log_entry get_warning_log_entry(uint32_t entry_index)
+{
+    return get_log_entry_if_present(WARNING_LOG_INDEX, entry_index);
+}
+
+struct log_entry get_error_log_entry(uint32_t entry_index)
+{
+    return get_log_entry_if_present(ERROR_LOG_INDEX, entry_index);
+}
+
+uint32_t get_telemetry_call_count(void)
+{
+    return call_counts_array[TELEMETRY_LOG_INDEX];
+}
+
+uint32_t get_warning_call_count(void)
+{
+    return call_counts_array[WARNING_LOG_INDEX];
+}
+
+uint32_t get_error_call_count(void)
+{
+    return call_counts_array[ERROR_LOG_INDEX];
+}
+
 void printf_telemetry_log(void)
 {
     printf_log(TELEMETRY_LOG_INDEX);
@@ -168,28 +357,247 @@ void printf_error_log(void)
 
 void printf_first_runtime_error_entry(void)
 {
+    START_PROFILING_SAMPLE(start_cycles);
     if (get_current_size_of_log(ERROR_LOG_INDEX) != 0) {
         print_log_entry(first_runtime_error_cause);
     }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
 }
 
 void printf_call_counts(void)
 {
+    START_PROFILING_SAMPLE(start_cycles);
     for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
         printf("%s: %" PRIu32 "\r\n", log_names_array[i], call_counts_array[i]);
     }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+void get_telemetry_statistics(struct running_statistics *stats)
+{
+    *stats = statistics_array[TELEMETRY_LOG_INDEX];
+}
+
+void get_warning_statistics(struct running_statistics *stats)
+{
+    *stats = statistics_array[WARNING_LOG_INDEX];
+}
+
+void get_error_statistics(struct running_statistics *stats)
+{
+    *stats = statistics_array[ERROR_LOG_INDEX];
+}
+
+bool get_call_site_statistics(const char *fail_message, struct running_statistics *stats)
+{
+    struct call_site_statistics *call_site = find_call_site(fail_message, false);
+    if (call_site == NULL) {
+        return false;
+    }
+
+    *stats = call_site->stats;
+    return true;
+}
+
+uint32_t get_untracked_call_site_event_count(void)
+{
+    return untracked_call_site_event_count;
+}
+
+void printf_statistics(void)
+{
+    START_PROFILING_SAMPLE(start_cycles);
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        printf_running_statistics(log_names_array[i], &statistics_array[i]);
+    }
+
+    for (uint32_t i = 0u; i < CALL_SITE_STATISTICS_CAPACITY; i++) {
+        if (call_site_statistics_array[i].fail_message != NULL) {
+            printf_running_statistics(call_site_statistics_array[i].fail_message,
+                                      &call_site_statistics_array[i].stats);
+        }
+    }
+
+    printf("untracked call sites: %" PRIu32 "\r\n", untracked_call_site_event_count);
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
+}
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+void set_capture_trigger(bool (*trigger)(enum runtime_log log, struct log_entry entry))
+{
+    user_capture_trigger = trigger;
+    rearm_capture();
+}
+
+void rearm_capture(void)
+{
+    capture_state = CAPTURE_ARMED;
+    memset(&capture_trigger_entry, 0, sizeof(capture_trigger_entry));
+    post_trigger_capture_size = 0;
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        captured_circular_buffer_array[i]->head = 0;
+        captured_circular_buffer_array[i]->current_size = 0;
+    }
+}
+
+bool is_capture_triggered(void)
+{
+    return capture_state != CAPTURE_ARMED;
+}
+
+bool is_capture_complete(void)
+{
+    return capture_state == CAPTURE_COMPLETE;
+}
+
+struct captured_log_entry get_capture_trigger_entry(void)
+{
+    return capture_trigger_entry;
+}
+
+uint32_t get_captured_telemetry_log_size(void)
+{
+    return get_captured_log_size(TELEMETRY_LOG_INDEX);
+}
+
+uint32_t get_captured_warning_log_size(void)
+{
+    return get_captured_log_size(WARNING_LOG_INDEX);
+}
+
+uint32_t get_captured_error_log_size(void)
+{
+    return get_captured_log_size(ERROR_LOG_INDEX);
+}
+
+struct log_entry get_captured_telemetry_log_entry(uint32_t entry_index)
+{
+    return get_captured_log_entry_if_present(TELEMETRY_LOG_INDEX, entry_index);
+}
+
+struct log_entry get_captured_warning_log_entry(uint32_t entry_index)
+{
+    return get_captured_log_entry_if_present(WARNING_LOG_INDEX, entry_index);
+}
+
+struct log_entry get_captured_error_log_entry(uint32_t entry_index)
+{
+    return get_captured_log_entry_if_present(ERROR_LOG_INDEX, entry_index);
+}
+
+uint32_t get_post_trigger_capture_size(void)
+{
+    return post_trigger_capture_size;
+}
+
+struct captured_log_entry get_post_trigger_capture_entry(uint32_t entry_index)
+{
+    if (entry_index >= post_trigger_capture_size) {
+        return (struct captured_log_entry){TELEMETRY_LOG, create_log_entry(0, NULL, 0)};
+    }
+    return post_trigger_entries[entry_index];
+}
+
+void printf_capture(void)
+{
+    START_PROFILING_SAMPLE(start_cycles);
+    if (is_capture_triggered()) {
+        printf("trigger: ");
+        print_captured_log_entry(capture_trigger_entry);
+        for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+            printf("%s:\r\n", log_names_array[i]);
+            for (uint32_t j = 0u; j < get_captured_log_size(log_category_array[i]); j++) {
+                print_log_entry(get_circular_buffer_entry(captured_circular_buffer_array[i], j));
+            }
+        }
+        printf("post-trigger:\r\n");
+        for (uint32_t i = 0u; i < post_trigger_capture_size; i++) {
+            print_captured_log_entry(post_trigger_entries[i]);
+        }
+    }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
+}
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+uintptr_t get_telemetry_call_site(uint32_t entry_index)
+{
+    return get_call_site_if_present(TELEMETRY_LOG_INDEX, entry_index);
+}
+
+uintptr_t get_warning_call_site(uint32_t entry_index)
+{
+    return get_call_site_if_present(WARNING_LOG_INDEX, entry_index);
+}
+
+uintptr_t get_error_call_site(uint32_t entry_index)
+{
+    return get_call_site_if_present(ERROR_LOG_INDEX, entry_index);
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+uintptr_t get_captured_telemetry_call_site(uint32_t entry_index)
+{
+    return get_captured_call_site_if_present(TELEMETRY_LOG_INDEX, entry_index);
+}
+
+uintptr_t get_captured_warning_call_site(uint32_t entry_index)
+{
+    return get_captured_call_site_if_present(WARNING_LOG_INDEX, entry_index);
+}
+
+uintptr_t get_captured_error_call_site(uint32_t entry_index)
+{
+    return get_captured_call_site_if_present(ERROR_LOG_INDEX, entry_index);
+}
+#endif
+
+void printf_call_sites(void)
+{
+    START_PROFILING_SAMPLE(start_cycles);
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        for (uint32_t j = 0u; j < get_current_size_of_log(log_category_array[i]); j++) {
+            printf("%s 0x%" PRIxPTR " ", log_names_array[i],
+                   get_call_site_if_present(log_category_array[i], j));
+            print_log_entry(get_entry_at_index(log_category_array[i], j));
+        }
+    }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
 }
+#endif
 
 void init_runtime_diagnostics()
 {
     reset_runtime_diagnostics_state();
     reset_all_circular_buffers();
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+    reset_all_statistics();
+#endif
+    reset_payload_log();
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+    reset_capture();
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+    reset_self_profiling();
+#endif
 }
 
 void deinit_runtime_diagnostics()
 {
     reset_runtime_diagnostics_state();
     reset_all_circular_buffers();
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+    reset_all_statistics();
+#endif
+    reset_payload_log();
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+    reset_capture();
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+    reset_self_profiling();
+#endif
 }
 
 /*----------------------------------------------------------------------------*/
@@ -204,6 +612,43 @@ static void reset_runtime_diagnostics_state(void)
     memset(&first_runtime_error_cause, 0, sizeof(first_runtime_error_cause));
     user_warning_handler = NULL;
     user_error_handler = NULL;
+    reset_handler_dispatch();
+    RUNTIME_ATOMIC_STORE(&runtime_subsystem_enable_mask, ALL_SUBSYSTEMS_ENABLED);
+#if defined(RUNTIME_DIAGNOSTICS_EXPORTER)
+    reset_runtime_exporter_cursors();
+#endif
+}
+
+/* subsystems past RUNTIME_SUBSYSTEMS_COUNT have no bit, so they're never enabled */
+static uint32_t get_subsystem_bit(uint32_t subsystem)
+{
+    if (subsystem >= RUNTIME_SUBSYSTEMS_COUNT) {
+        return 0u;
+    }
+    return 1u << subsystem;
+}
+
+static void log_telemetry_entry(struct log_entry new_entry)
+{
+    add_entry_to_circular_buffer(TELEMETRY_LOG_INDEX, new_entry);
+}
+
+static void log_warning_entry(struct log_entry new_entry)
+{
+    add_entry_to_circular_buffer(WARNING_LOG_INDEX, new_entry);
+
+    if (is_log_full(WARNING_LOG_INDEX)) {
+        call_warning_handler_if_set();
+    }
+}
+
+static void log_error_entry(struct log_entry new_entry)
+{
+    add_entry_to_circular_buffer(ERROR_LOG_INDEX, new_entry);
+
+    save_entry_if_first_runtime_error(new_entry);
+    assert_runtime_error_flag();
+    call_error_handler_if_set();
 }
 
 static struct log_entry create_log_entry(uint32_t timestamp, const char *fail_message,
@@ -214,6 +659,7 @@ static struct log_entry create_log_entry(uint32_t timestamp, const char *fail_me
 
 static void add_entry_to_circular_buffer(enum log_category log_index, struct log_entry new_entry)
 {
+    START_PROFILING_SAMPLE(start_cycles);
     call_counts_array[log_index]++;
 
     struct circular_buffer *target_cb = circular_buffer_array[log_index];
@@ -223,6 +669,14 @@ static void add_entry_to_circular_buffer(enum log_category log_index, struct log
     if (target_cb->current_size != target_cb->log_capacity) {
         target_cb->current_size++;
     }
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+    update_log_statistics(log_index, new_entry);
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+    update_capture(log_index, new_entry);
+#endif
+    END_PROFILING_SAMPLE((enum profiling_probe)log_index, start_cycles);
 }
 
 static bool is_log_full(enum log_category log_index)
@@ -251,14 +705,14 @@ static void assert_runtime_error_flag(void)
 static void call_warning_handler_if_set(void)
 {
     if (user_warning_handler_set) {
-        user_warning_handler();
+        dispatch_handler(WARNING_HANDLER_EVENT, user_warning_handler);
     }
 }
 
 static void call_error_handler_if_set(void)
 {
     if (user_error_handler_set) {
-        user_error_handler();
+        dispatch_handler(ERROR_HANDLER_EVENT, user_error_handler);
     }
 }
 
@@ -273,6 +727,9 @@ static void reset_circular_buffer(enum log_category log_index)
     reset_log_entries(target_cb->log_entries, target_cb->log_capacity);
     target_cb->head = 0;
     target_cb->current_size = 0;
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+    memset(call_sites_array[log_index], 0, sizeof(uintptr_t) * target_cb->log_capacity);
+#endif
 }
 
 static void reset_all_circular_buffers(void)
@@ -284,12 +741,30 @@ static void reset_all_circular_buffers(void)
 
 static struct log_entry get_entry_at_index(enum log_category log_index, uint32_t entry_index)
 {
-    struct circular_buffer *target_cb = circular_buffer_array[log_index];
+    return get_circular_buffer_entry(circular_buffer_array[log_index], entry_index);
+}
+
+static struct log_entry get_circular_buffer_entry(const struct circular_buffer *target_cb,
+                                                  uint32_t entry_index)
+{
+    return target_cb->log_entries[get_buffer_index(target_cb, entry_index)];
+}
+
+static uint32_t get_buffer_index(const struct circular_buffer *target_cb, uint32_t entry_index)
+{
     uint32_t oldest_entry_index =
             (target_cb->head + target_cb->log_capacity - target_cb->current_size)
             % target_cb->log_capacity;
-    uint32_t return_entry_index = (oldest_entry_index + entry_index) % target_cb->log_capacity;
-    return target_cb->log_entries[return_entry_index];
+    return (oldest_entry_index + entry_index) % target_cb->log_capacity;
+}
+
+static struct log_entry get_log_entry_if_present(enum log_category log_index,
+                                                 uint32_t entry_index)
+{
+    if (entry_index >= get_current_size_of_log(log_index)) {
+        return create_log_entry(0, NULL, 0);
+    }
+    return get_entry_at_index(log_index, entry_index);
 }
 
 static void print_log_entry(struct log_entry entry)
@@ -299,9 +774,183 @@ static void print_log_entry(struct log_entry entry)
 
 static void printf_log(enum log_category log_index)
 {
+    START_PROFILING_SAMPLE(start_cycles);
     uint32_t current_size = circular_buffer_array[log_index]->current_size;
     for (uint32_t i = 0u; i < current_size; i++) {
         struct log_entry entry = get_entry_at_index(log_index, i);
         print_log_entry(entry);
     }
+    END_PROFILING_SAMPLE(LOG_DUMP_PROFILING_PROBE, start_cycles);
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+static void reset_all_statistics(void)
+{
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        reset_running_statistics(&statistics_array[i]);
+    }
+    memset(call_site_statistics_array, 0, sizeof(call_site_statistics_array));
+    untracked_call_site_event_count = 0;
+}
+
+static void update_log_statistics(enum log_category log_index, struct log_entry new_entry)
+{
+    update_running_statistics(&statistics_array[log_index], new_entry.timestamp,
+                              new_entry.fail_value);
+
+    struct call_site_statistics *call_site = find_call_site(new_entry.fail_message, true);
+    if (call_site == NULL) {
+        untracked_call_site_event_count++;
+        return;
+    }
+    update_running_statistics(&call_site->stats, new_entry.timestamp, new_entry.fail_value);
+}
+
+static uint32_t hash_call_site(const char *fail_message)
+{
+    /* multiplicative hash- upper bits of the product are the well mixed ones */
+    return (((uint32_t)(uintptr_t)fail_message * 2654435761u) >> 16)
+           % CALL_SITE_STATISTICS_CAPACITY;
+}
+
+/* call sites are identified by their fail_message pointer */
+static struct call_site_statistics *find_call_site(const char *fail_message, bool add_if_missing)
+{
+    if (fail_message == NULL) {
+        return NULL;
+    }
+
+    uint32_t slot = hash_call_site(fail_message);
+    for (uint32_t i = 0u; i < CALL_SITE_STATISTICS_CAPACITY; i++) {
+        struct call_site_statistics *call_site = &call_site_statistics_array[slot];
+        if (call_site->fail_message == fail_message) {
+            return call_site;
+        }
+        if (call_site->fail_message == NULL) {
+            if (!add_if_missing) {
+                return NULL;
+            }
+            call_site->fail_message = fail_message;
+            return call_site;
+        }
+        slot = (slot + 1u) % CALL_SITE_STATISTICS_CAPACITY;
+    }
+
+    return NULL;
+}
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+static void reset_capture(void)
+{
+    user_capture_trigger = NULL;
+    rearm_capture();
+    memset(post_trigger_entries, 0, sizeof(post_trigger_entries));
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        reset_log_entries(captured_circular_buffer_array[i]->log_entries,
+                          captured_circular_buffer_array[i]->log_capacity);
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+        memset(captured_call_sites_array[i], 0,
+               sizeof(uintptr_t) * captured_circular_buffer_array[i]->log_capacity);
+#endif
+    }
+}
+
+/* runs on every entry, so past the trigger it's one append until the capture is full */
+static void update_capture(enum log_category log_index, struct log_entry new_entry)
+{
+    if (capture_state == CAPTURE_COMPLETE) {
+        return;
+    }
+
+    struct captured_log_entry captured = {(enum runtime_log)log_index, new_entry};
+    if (capture_state == CAPTURE_RECORDING) {
+        post_trigger_entries[post_trigger_capture_size] = captured;
+        post_trigger_capture_size++;
+        if (post_trigger_capture_size == POST_TRIGGER_CAPTURE_CAPACITY) {
+            capture_state = CAPTURE_COMPLETE;
+        }
+        return;
+    }
+
+    if (is_capture_trigger(log_index, new_entry)) {
+        capture_trigger_entry = captured;
+        freeze_all_circular_buffers();
+        capture_state = CAPTURE_RECORDING;
+    }
+}
+
+static bool is_capture_trigger(enum log_category log_index, struct log_entry new_entry)
+{
+    if (user_capture_trigger == NULL) {
+        return log_index == ERROR_LOG_INDEX;
+    }
+    return user_capture_trigger((enum runtime_log)log_index, new_entry);
+}
+
+/* one bulk copy per log- the frozen copies keep the live head, so no reordering is needed */
+static void freeze_all_circular_buffers(void)
+{
+    for (uint32_t i = 0u; i < LOG_CATEGORIES_COUNT; i++) {
+        struct circular_buffer *live_cb = circular_buffer_array[i];
+        struct circular_buffer *captured_cb = captured_circular_buffer_array[i];
+        memcpy(captured_cb->log_entries, live_cb->log_entries,
+               sizeof(struct log_entry) * live_cb->log_capacity);
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+        memcpy(captured_call_sites_array[i], call_sites_array[i],
+               sizeof(uintptr_t) * live_cb->log_capacity);
+#endif
+        captured_cb->head = live_cb->head;
+        captured_cb->current_size = live_cb->current_size;
+    }
+}
+
+static uint32_t get_captured_log_size(enum log_category log_index)
+{
+    return captured_circular_buffer_array[log_index]->current_size;
+}
+
+static struct log_entry get_captured_log_entry_if_present(enum log_category log_index,
+                                                          uint32_t entry_index)
+{
+    if (entry_index >= get_captured_log_size(log_index)) {
+        return create_log_entry(0, NULL, 0);
+    }
+    return get_circular_buffer_entry(captured_circular_buffer_array[log_index], entry_index);
+}
+
+static void print_captured_log_entry(struct captured_log_entry captured)
+{
+    printf("%s ", log_names_array[captured.log]);
+    print_log_entry(captured.entry);
+}
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+/* called before the entry is added, so it lands at the same index as the entry */
+static void save_call_site(enum log_category log_index, uintptr_t call_site)
+{
+    call_sites_array[log_index][circular_buffer_array[log_index]->head] = call_site;
+}
+
+static uintptr_t get_call_site_if_present(enum log_category log_index, uint32_t entry_index)
+{
+    struct circular_buffer *target_cb = circular_buffer_array[log_index];
+    if (entry_index >= target_cb->current_size) {
+        return 0u;
+    }
+    return call_sites_array[log_index][get_buffer_index(target_cb, entry_index)];
+}
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW) && defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+static uintptr_t get_captured_call_site_if_present(enum log_category log_index,
+                                                   uint32_t entry_index)
+{
+    struct circular_buffer *captured_cb = captured_circular_buffer_array[log_index];
+    if (entry_index >= captured_cb->current_size) {
+        return 0u;
+    }
+    return captured_call_sites_array[log_index][get_buffer_index(captured_cb, entry_index)];
 }
+#endif
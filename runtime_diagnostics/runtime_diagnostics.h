@@ -7,6 +7,20 @@
 #ifndef RUNTIME_DIAGNOSTICS_H_
 #define RUNTIME_DIAGNOSTICS_H_
 
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "handler_dispatch.h"
+#include "payload_log.h"
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+#include "running_statistics.h"
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+#include "self_profiling.h"
+#endif
+
 /*----------------------------------------------------------------------------*/
 /*                             Public Definitions                             */
 /*----------------------------------------------------------------------------*/
@@ -14,7 +28,36 @@ enum
 {
     TELEMETRY_LOG_CAPACITY = 32,
     WARNING_LOG_CAPACITY = 16,
-    ERROR_LOG_CAPACITY = 8
+    ERROR_LOG_CAPACITY = 8,
+    CALL_SITE_STATISTICS_CAPACITY = 16,
+    POST_TRIGGER_CAPTURE_CAPACITY = 16
+};
+
+/* subsystem tags index the enable mask, one bit each- higher tags are always dropped */
+enum
+{
+    RUNTIME_SUBSYSTEMS_COUNT = 32
+};
+
+#define ALL_SUBSYSTEMS_ENABLED UINT32_MAX
+
+enum runtime_log
+{
+    TELEMETRY_LOG = 0,
+    WARNING_LOG,
+    ERROR_LOG
+};
+
+/* shared w/ runtime_log.hpp so both front-ends produce the same entry layout */
+struct log_entry {
+    uint32_t timestamp;
+    const char *fail_message;
+    uint32_t fail_value;
+};
+
+struct captured_log_entry {
+    enum runtime_log log;
+    struct log_entry entry;
 };
 
 /*----------------------------------------------------------------------------*/
@@ -24,6 +67,58 @@ void RUNTIME_TELEMETRY(uint32_t timestamp, const char *fail_message, uint32_t fa
 void RUNTIME_WARNING(uint32_t timestamp, const char *fail_message, uint32_t fail_value);
 void RUNTIME_ERROR(uint32_t timestamp, const char *fail_message, uint32_t fail_value);
 
+/* the payload goes to the payload log, fail_value is logged as the stored (truncated) size */
+void RUNTIME_TELEMETRY_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                               uint32_t payload_size);
+void RUNTIME_WARNING_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                             uint32_t payload_size);
+void RUNTIME_ERROR_PAYLOAD(uint32_t timestamp, const char *fail_message, const void *payload,
+                           uint32_t payload_size);
+
+/*
+ * dropped before any other work unless the subsystem's bit is set in the enable
+ * mask- the check is inlined at the call site, so a dropped call is one load
+ * and a branch, and its other arguments aren't evaluated
+ */
+#define RUNTIME_TELEMETRY_TAGGED(subsystem, timestamp, fail_message, fail_value) \
+    do {                                                                         \
+        if (is_runtime_subsystem_enabled(subsystem)) {                           \
+            RUNTIME_TELEMETRY((timestamp), (fail_message), (fail_value));        \
+        }                                                                        \
+    } while (0)
+#define RUNTIME_WARNING_TAGGED(subsystem, timestamp, fail_message, fail_value) \
+    do {                                                                       \
+        if (is_runtime_subsystem_enabled(subsystem)) {                         \
+            RUNTIME_WARNING((timestamp), (fail_message), (fail_value));        \
+        }                                                                      \
+    } while (0)
+#define RUNTIME_ERROR_TAGGED(subsystem, timestamp, fail_message, fail_value) \
+    do {                                                                     \
+        if (is_runtime_subsystem_enabled(subsystem)) {                       \
+            RUNTIME_ERROR((timestamp), (fail_message), (fail_value));        \
+        }                                                                    \
+    } while (0)
+
+/* read-only outside of the library- use the functions below to change it */
+extern volatile uint32_t runtime_subsystem_enable_mask;
+
+static inline bool is_runtime_subsystem_enabled(uint32_t subsystem)
+{
+    /* relaxed- the mask only filters calls, it doesn't order anything */
+#if defined(__ATOMIC_RELAXED)
+    uint32_t mask = __atomic_load_n(&runtime_subsystem_enable_mask, __ATOMIC_RELAXED);
+#else
+    uint32_t mask = runtime_subsystem_enable_mask;
+#endif
+    return (subsystem < RUNTIME_SUBSYSTEMS_COUNT) && (((mask >> subsystem) & 1u) != 0u);
+}
+
+/* safe to call from any context- all subsystems are enabled after init */
+void set_subsystem_enable_mask(uint32_t mask);
+uint32_t get_subsystem_enable_mask(void);
+void enable_subsystem(uint32_t subsystem);
+void disable_subsystem(uint32_t subsystem);
+
 void set_warning_handler(void (*handler)(void));
 void set_error_handler(void (*handler)(void));
 
@@ -31,12 +126,71 @@ uint32_t get_telemetry_log_current_size(void);
 uint32_t get_warning_log_current_size(void);
 uint32_t get_error_log_current_size(void);
 
+/* entry_index 0 is the oldest entry- out of range indexes return an empty entry */
+struct log_entry get_telemetry_log_entry(uint32_t entry_index);
+struct log_entry get_warning_log_entry(uint32_t entry_index);
+struct log_entry get_error_log_entry(uint32_t entry_index);
+
+uint32_t get_telemetry_call_count(void);
+uint32_t get_warning_call_count(void);
+uint32_t get_error_call_count(void);
+
 void printf_telemetry_log(void);
 void printf_warning_log(void);
 void printf_error_log(void);
 void printf_first_runtime_error_entry(void);
 void printf_call_counts(void);
 
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+/* call sites are identified by their fail_message pointer */
+void get_telemetry_statistics(struct running_statistics *stats);
+void get_warning_statistics(struct running_statistics *stats);
+void get_error_statistics(struct running_statistics *stats);
+bool get_call_site_statistics(const char *fail_message, struct running_statistics *stats);
+uint32_t get_untracked_call_site_event_count(void);
+void printf_statistics(void);
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+/*
+ * the capture freezes a copy of every log when the trigger fires, then records
+ * the next POST_TRIGGER_CAPTURE_CAPACITY entries of any log. The trigger is
+ * checked on every entry- NULL restores the default, the first RUNTIME_ERROR.
+ * Setting a trigger rearms the capture
+ */
+void set_capture_trigger(bool (*trigger)(enum runtime_log log, struct log_entry entry));
+void rearm_capture(void);
+bool is_capture_triggered(void);
+bool is_capture_complete(void);
+struct captured_log_entry get_capture_trigger_entry(void);
+
+/* entry_index 0 is the oldest entry- out of range indexes return an empty entry */
+uint32_t get_captured_telemetry_log_size(void);
+uint32_t get_captured_warning_log_size(void);
+uint32_t get_captured_error_log_size(void);
+struct log_entry get_captured_telemetry_log_entry(uint32_t entry_index);
+struct log_entry get_captured_warning_log_entry(uint32_t entry_index);
+struct log_entry get_captured_error_log_entry(uint32_t entry_index);
+uint32_t get_post_trigger_capture_size(void);
+struct captured_log_entry get_post_trigger_capture_entry(uint32_t entry_index);
+void printf_capture(void);
+#endif
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+/* return address of the RUNTIME_* call that logged the entry at entry_index- 0 if out of range */
+uintptr_t get_telemetry_call_site(uint32_t entry_index);
+uintptr_t get_warning_call_site(uint32_t entry_index);
+uintptr_t get_error_call_site(uint32_t entry_index);
+/* one "<log> 0x<address> <entry>" line per entry- see tools/symbolize_call_sites.py */
+void printf_call_sites(void);
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+/* frozen w/ the captured logs- indexed like get_captured_*_log_entry() */
+uintptr_t get_captured_telemetry_call_site(uint32_t entry_index);
+uintptr_t get_captured_warning_call_site(uint32_t entry_index);
+uintptr_t get_captured_error_call_site(uint32_t entry_index);
+#endif
+#endif
+
 /* init and deinit are for testing only */
 void init_runtime_diagnostics();
 void deinit_runtime_diagnostics();
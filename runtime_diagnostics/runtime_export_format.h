@@ -0,0 +1,44 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_export_format.h                               */
+/*                                                                            */
+/* Binary framing shared by runtime_exporter.c and the reference collector    */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef RUNTIME_EXPORT_FORMAT_H_
+#define RUNTIME_EXPORT_FORMAT_H_
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+/*
+ * All fields are little-endian. A stream is a sequence of frames:
+ *
+ * frame header (EXPORT_FRAME_HEADER_SIZE bytes)
+ *   u32 frame_size            bytes following this field
+ *   u16 magic                 EXPORT_FRAME_MAGIC
+ *   u8  version               EXPORT_FRAME_VERSION
+ *   u8  reserved
+ *   u32 pid                   exporting process
+ *   u32 dropped_entry_count   entries lost since the previous frame
+ *   u16 entry_count
+ *   u16 reserved
+ *
+ * entry_count x entry (EXPORT_ENTRY_HEADER_SIZE bytes + message_length)
+ *   u32 sequence              0-based call number within the category
+ *   u32 timestamp
+ *   u32 fail_value
+ *   u8  category              0 telemetry, 1 warning, 2 error
+ *   u8  message_length        fail_message is truncated, not NUL terminated
+ *   u16 reserved
+ *   u8  message[message_length]
+ */
+enum
+{
+    EXPORT_FRAME_MAGIC = 0x5244,
+    EXPORT_FRAME_VERSION = 1,
+    EXPORT_FRAME_HEADER_SIZE = 20,
+    EXPORT_ENTRY_HEADER_SIZE = 16,
+    EXPORT_MESSAGE_MAX_LENGTH = 255
+};
+
+#endif /* RUNTIME_EXPORT_FORMAT_H_ */
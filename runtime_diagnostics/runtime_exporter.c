@@ -0,0 +1,417 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_exporter.c                                    */
+/*                                                                            */
+/* Batched, non-blocking export of new log entries over a socket or pipe      */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+/* for SOCK_NONBLOCK, SOCK_CLOEXEC, and S_ISSOCK w/ -std=c11 */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "runtime_diagnostics.h"
+#include "runtime_export_format.h"
+#include "runtime_exporter.h"
+
+/*----------------------------------------------------------------------------*/
+/*                           Struct, Enum, Typedefs                           */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    EXPORT_CATEGORIES_COUNT = 3,
+    EXPORT_MAX_ENTRIES_PER_FRAME = TELEMETRY_LOG_CAPACITY + WARNING_LOG_CAPACITY
+                                   + ERROR_LOG_CAPACITY,
+    EXPORT_MAX_IOVECS = 1 + (2 * EXPORT_MAX_ENTRIES_PER_FRAME)
+};
+
+/*
+ * at most one frame is in flight- entry headers are encoded here, messages are
+ * sent straight from the fail_message strings
+ */
+struct export_frame {
+    uint8_t header[EXPORT_FRAME_HEADER_SIZE];
+    uint8_t entry_headers[EXPORT_MAX_ENTRIES_PER_FRAME][EXPORT_ENTRY_HEADER_SIZE];
+    struct iovec iovecs[EXPORT_MAX_IOVECS];
+    uint32_t iovecs_count;
+    uint32_t next_iovec;
+    uint32_t entry_count;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static bool connect_to_collector(void);
+static void disconnect_from_collector(void);
+static bool is_frame_in_flight(void);
+static bool flush_frame(void);
+static ssize_t write_without_sigpipe(const struct iovec *iovecs, int iovecs_count);
+static uint32_t count_new_entries(uint32_t category);
+static void export_entries_still_in_logs(void);
+static void skip_new_entries(void);
+static void build_frame(void);
+static void add_entry_to_frame(uint32_t category, uint32_t sequence, struct log_entry entry);
+static void put_u16(uint8_t *destination, uint16_t value);
+static void put_u32(uint8_t *destination, uint32_t value);
+
+/*----------------------------------------------------------------------------*/
+/*                               Private Globals                              */
+/*----------------------------------------------------------------------------*/
+uint32_t (*export_call_count_functions[EXPORT_CATEGORIES_COUNT])(void) = {
+        get_telemetry_call_count, get_warning_call_count, get_error_call_count};
+uint32_t (*export_current_size_functions[EXPORT_CATEGORIES_COUNT])(void) = {
+        get_telemetry_log_current_size, get_warning_log_current_size, get_error_log_current_size};
+struct log_entry (*export_log_entry_functions[EXPORT_CATEGORIES_COUNT])(uint32_t) = {
+        get_telemetry_log_entry, get_warning_log_entry, get_error_log_entry};
+
+int exporter_fd = -1;
+bool exporter_owns_fd = false;
+bool exporter_fd_is_socket = false;
+bool exporter_started = false;
+char exporter_socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)] = {0};
+uint32_t polls_since_reconnect_attempt = 0;
+
+uint32_t exported_call_counts[EXPORT_CATEGORIES_COUNT] = {0};
+uint32_t exporter_dropped_entry_count = 0;
+uint32_t dropped_since_last_frame = 0;
+struct export_frame export_frame = {0};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+bool start_runtime_exporter(const char *socket_path)
+{
+    if (exporter_started || (strlen(socket_path) >= sizeof(exporter_socket_path))) {
+        return false;
+    }
+
+    strcpy(exporter_socket_path, socket_path);
+    exporter_started = true;
+    exporter_owns_fd = true;
+    exporter_fd_is_socket = true;
+    export_entries_still_in_logs();
+    connect_to_collector();
+    return true;
+}
+
+bool start_runtime_exporter_on_fd(int fd)
+{
+    struct stat fd_stat;
+    int fd_flags = fcntl(fd, F_GETFL);
+    if (exporter_started || (fd_flags < 0) || (fstat(fd, &fd_stat) != 0)
+        || (fcntl(fd, F_SETFL, fd_flags | O_NONBLOCK) != 0)) {
+        return false;
+    }
+
+    exporter_fd = fd;
+    exporter_started = true;
+    exporter_owns_fd = false;
+    exporter_fd_is_socket = S_ISSOCK(fd_stat.st_mode);
+    exporter_socket_path[0] = '\0';
+    export_entries_still_in_logs();
+    return true;
+}
+
+void stop_runtime_exporter(void)
+{
+    disconnect_from_collector();
+    memset(&export_frame, 0, sizeof(export_frame));
+    memset(exported_call_counts, 0, sizeof(exported_call_counts));
+    exporter_started = false;
+    exporter_dropped_entry_count = 0;
+    dropped_since_last_frame = 0;
+    polls_since_reconnect_attempt = 0;
+}
+
+uint32_t poll_runtime_exporter(void)
+{
+    if (!exporter_started) {
+        return 0u;
+    }
+
+    if ((exporter_fd < 0) && !connect_to_collector()) {
+        skip_new_entries();
+        return 0u;
+    }
+
+    /* a slow collector leaves new entries in the logs until this frame is out */
+    if (is_frame_in_flight()) {
+        uint32_t entry_count = export_frame.entry_count;
+        return flush_frame() ? entry_count : 0u;
+    }
+
+    build_frame();
+    if (!is_frame_in_flight()) {
+        return 0u;
+    }
+
+    uint32_t entry_count = export_frame.entry_count;
+    return flush_frame() ? entry_count : 0u;
+}
+
+bool is_runtime_exporter_connected(void)
+{
+    return exporter_fd >= 0;
+}
+
+uint32_t get_exporter_dropped_entry_count(void)
+{
+    return exporter_dropped_entry_count;
+}
+
+void reset_runtime_exporter_cursors(void)
+{
+    memset(exported_call_counts, 0, sizeof(exported_call_counts));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static bool connect_to_collector(void)
+{
+    if (exporter_socket_path[0] == '\0') {
+        return exporter_fd >= 0;
+    }
+
+    if ((polls_since_reconnect_attempt++ % EXPORTER_RECONNECT_INTERVAL) != 0u) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, exporter_socket_path);
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    exporter_fd = fd;
+    polls_since_reconnect_attempt = 0;
+    return true;
+}
+
+static void disconnect_from_collector(void)
+{
+    if ((exporter_fd >= 0) && exporter_owns_fd) {
+        close(exporter_fd);
+    }
+    exporter_fd = -1;
+}
+
+static bool is_frame_in_flight(void)
+{
+    return export_frame.next_iovec < export_frame.iovecs_count;
+}
+
+static bool flush_frame(void)
+{
+    while (is_frame_in_flight()) {
+        struct iovec *iovecs = &export_frame.iovecs[export_frame.next_iovec];
+        int iovecs_count = (int)(export_frame.iovecs_count - export_frame.next_iovec);
+        ssize_t written;
+
+        if (exporter_fd_is_socket) {
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_iov = iovecs;
+            message.msg_iovlen = (size_t)iovecs_count;
+            written = sendmsg(exporter_fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+        } else {
+            written = write_without_sigpipe(iovecs, iovecs_count);
+        }
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                return false;
+            }
+
+            /* collector went away- the frame is lost, reconnect on a later poll */
+            exporter_dropped_entry_count += export_frame.entry_count;
+            dropped_since_last_frame += export_frame.entry_count;
+            memset(&export_frame, 0, sizeof(export_frame));
+            disconnect_from_collector();
+            return false;
+        }
+
+        size_t remaining = (size_t)written;
+        while ((remaining > 0u) && is_frame_in_flight()) {
+            struct iovec *iovec = &export_frame.iovecs[export_frame.next_iovec];
+            if (remaining < iovec->iov_len) {
+                iovec->iov_base = (uint8_t *)iovec->iov_base + remaining;
+                iovec->iov_len -= remaining;
+                remaining = 0u;
+            } else {
+                remaining -= iovec->iov_len;
+                export_frame.next_iovec++;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ * pipes have no MSG_NOSIGNAL- SIGPIPE is blocked on the calling thread for the
+ * write, and the one raised by an EPIPE is consumed before it's unblocked
+ * (unless it was already pending for someone else)
+ */
+static ssize_t write_without_sigpipe(const struct iovec *iovecs, int iovecs_count)
+{
+    sigset_t sigpipe_set;
+    sigset_t pending_set;
+    sigset_t old_set;
+    sigemptyset(&sigpipe_set);
+    sigaddset(&sigpipe_set, SIGPIPE);
+
+    sigpending(&pending_set);
+    bool sigpipe_was_pending = sigismember(&pending_set, SIGPIPE) == 1;
+    pthread_sigmask(SIG_BLOCK, &sigpipe_set, &old_set);
+
+    ssize_t written = writev(exporter_fd, iovecs, iovecs_count);
+
+    if ((written < 0) && (errno == EPIPE) && !sigpipe_was_pending) {
+        const struct timespec no_wait = {0, 0};
+        while ((sigtimedwait(&sigpipe_set, NULL, &no_wait) < 0) && (errno == EINTR)) {
+        }
+        errno = EPIPE;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+    return written;
+}
+
+static uint32_t count_new_entries(uint32_t category)
+{
+    return export_call_count_functions[category]() - exported_call_counts[category];
+}
+
+static void export_entries_still_in_logs(void)
+{
+    for (uint32_t i = 0u; i < EXPORT_CATEGORIES_COUNT; i++) {
+        exported_call_counts[i] = export_call_count_functions[i]()
+                                  - export_current_size_functions[i]();
+    }
+}
+
+static void skip_new_entries(void)
+{
+    for (uint32_t i = 0u; i < EXPORT_CATEGORIES_COUNT; i++) {
+        uint32_t new_entries = count_new_entries(i);
+        exporter_dropped_entry_count += new_entries;
+        dropped_since_last_frame += new_entries;
+        exported_call_counts[i] += new_entries;
+    }
+}
+
+static void build_frame(void)
+{
+    memset(&export_frame, 0, sizeof(export_frame));
+    export_frame.iovecs_count = 1u;
+
+    for (uint32_t category = 0u; category < EXPORT_CATEGORIES_COUNT; category++) {
+        uint32_t new_entries = count_new_entries(category);
+        uint32_t current_size = export_current_size_functions[category]();
+        uint32_t available_entries = (new_entries < current_size) ? new_entries : current_size;
+
+        /* overwritten before they could be exported */
+        uint32_t lost_entries = new_entries - available_entries;
+        exporter_dropped_entry_count += lost_entries;
+        dropped_since_last_frame += lost_entries;
+
+        uint32_t first_sequence = exported_call_counts[category] + lost_entries;
+        uint32_t first_index = current_size - available_entries;
+        for (uint32_t i = 0u; i < available_entries; i++) {
+            add_entry_to_frame(category, first_sequence + i,
+                               export_log_entry_functions[category](first_index + i));
+        }
+        exported_call_counts[category] += new_entries;
+    }
+
+    if ((export_frame.entry_count == 0u) && (dropped_since_last_frame == 0u)) {
+        export_frame.iovecs_count = 0u;
+        return;
+    }
+
+    uint32_t frame_size = 0u;
+    for (uint32_t i = 1u; i < export_frame.iovecs_count; i++) {
+        frame_size += (uint32_t)export_frame.iovecs[i].iov_len;
+    }
+    frame_size += EXPORT_FRAME_HEADER_SIZE - sizeof(uint32_t);
+
+    uint8_t *header = export_frame.header;
+    put_u32(&header[0], frame_size);
+    put_u16(&header[4], EXPORT_FRAME_MAGIC);
+    header[6] = EXPORT_FRAME_VERSION;
+    header[7] = 0u;
+    put_u32(&header[8], (uint32_t)getpid());
+    put_u32(&header[12], dropped_since_last_frame);
+    put_u16(&header[16], (uint16_t)export_frame.entry_count);
+    put_u16(&header[18], 0u);
+    export_frame.iovecs[0].iov_base = header;
+    export_frame.iovecs[0].iov_len = EXPORT_FRAME_HEADER_SIZE;
+
+    dropped_since_last_frame = 0u;
+}
+
+static void add_entry_to_frame(uint32_t category, uint32_t sequence, struct log_entry entry)
+{
+    uint8_t *entry_header = export_frame.entry_headers[export_frame.entry_count];
+    size_t message_length = (entry.fail_message != NULL) ? strlen(entry.fail_message) : 0u;
+    if (message_length > EXPORT_MESSAGE_MAX_LENGTH) {
+        message_length = EXPORT_MESSAGE_MAX_LENGTH;
+    }
+
+    put_u32(&entry_header[0], sequence);
+    put_u32(&entry_header[4], entry.timestamp);
+    put_u32(&entry_header[8], entry.fail_value);
+    entry_header[12] = (uint8_t)category;
+    entry_header[13] = (uint8_t)message_length;
+    put_u16(&entry_header[14], 0u);
+
+    export_frame.iovecs[export_frame.iovecs_count].iov_base = entry_header;
+    export_frame.iovecs[export_frame.iovecs_count].iov_len = EXPORT_ENTRY_HEADER_SIZE;
+    export_frame.iovecs_count++;
+    if (message_length > 0u) {
+        export_frame.iovecs[export_frame.iovecs_count].iov_base = (void *)entry.fail_message;
+        export_frame.iovecs[export_frame.iovecs_count].iov_len = message_length;
+        export_frame.iovecs_count++;
+    }
+    export_frame.entry_count++;
+}
+
+static void put_u16(uint8_t *destination, uint16_t value)
+{
+    destination[0] = (uint8_t)value;
+    destination[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *destination, uint32_t value)
+{
+    destination[0] = (uint8_t)value;
+    destination[1] = (uint8_t)(value >> 8);
+    destination[2] = (uint8_t)(value >> 16);
+    destination[3] = (uint8_t)(value >> 24);
+}
@@ -0,0 +1,50 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_exporter.h                                    */
+/*                                                                            */
+/* Interface to streaming new log entries to a local collector (POSIX only)   */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef RUNTIME_EXPORTER_H_
+#define RUNTIME_EXPORTER_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum
+{
+    /* polls between attempts to reconnect to a missing collector */
+    EXPORTER_RECONNECT_INTERVAL = 64
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+/* only built w/ ENABLE_RUNTIME_DIAGNOSTICS_EXPORTER */
+#if defined(RUNTIME_DIAGNOSTICS_EXPORTER)
+/* a missing collector isn't an error- entries are dropped until it shows up */
+bool start_runtime_exporter(const char *socket_path);
+/* fd is e.g. the write end of a pipe- it's made non-blocking, not closed */
+bool start_runtime_exporter_on_fd(int fd);
+void stop_runtime_exporter(void);
+
+/*
+ * sends one frame w/ every entry logged since the last poll- never blocks.
+ * Call from the same context as RUNTIME_* calls (e.g. the main loop), since
+ * the logs are read directly. Returns the number of entries sent
+ */
+uint32_t poll_runtime_exporter(void);
+
+bool is_runtime_exporter_connected(void);
+uint32_t get_exporter_dropped_entry_count(void);
+
+/* called by init_runtime_diagnostics()- the logs restart from call count 0 */
+void reset_runtime_exporter_cursors(void);
+#endif
+
+#endif /* RUNTIME_EXPORTER_H_ */
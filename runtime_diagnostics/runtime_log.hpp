@@ -0,0 +1,169 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : runtime_log.hpp                                       */
+/*                                                                            */
+/* Header-only C++ front-end to runtime logging w/ compile-time sized logs    */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef RUNTIME_LOG_HPP_
+#define RUNTIME_LOG_HPP_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+
+extern "C"
+{
+
+#include "runtime_diagnostics.h"
+
+}
+
+namespace runtime_diagnostics
+{
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum class LogCategory
+{
+    Telemetry,
+    Warning,
+    Error
+};
+
+/*
+ * Handler policies are plain types w/ static hooks, so the calls resolve at
+ * compile time and can be inlined into RuntimeLog::add()
+ *  - on_warning_log_full(): called when a Warning log reaches capacity
+ *  - on_runtime_error(): called in response to every add() on an Error log
+ */
+struct NoHandlerPolicy
+{
+    static void on_warning_log_full() {}
+    static void on_runtime_error() {}
+};
+
+/*
+ * Entries are stored as the same struct log_entry used by runtime_diagnostics.c
+ * and printed in the same format, so dumps from either front-end look the same
+ */
+inline void print_log_entry(const log_entry &entry)
+{
+    printf("%" PRIu32 " %s %" PRIu32 "\r\n", entry.timestamp, entry.fail_message,
+           entry.fail_value);
+}
+
+template <std::uint32_t Capacity, LogCategory Category, typename Policy = NoHandlerPolicy>
+class RuntimeLog
+{
+    static_assert(Capacity > 0u, "RuntimeLog capacity must be non-zero");
+
+public:
+    static constexpr std::uint32_t CAPACITY{Capacity};
+    static constexpr LogCategory CATEGORY{Category};
+    static constexpr bool CAPACITY_IS_POWER_OF_TWO{(Capacity & (Capacity - 1u)) == 0u};
+
+    void add(std::uint32_t timestamp, const char *fail_message, std::uint32_t fail_value)
+    {
+        const log_entry new_entry{timestamp, fail_message, fail_value};
+
+        call_count++;
+        log_entries[head] = new_entry;
+        head = wrap_index(head + 1u);
+        if (current_size != Capacity) {
+            current_size++;
+        }
+
+        if (Category == LogCategory::Warning) {
+            if (is_full()) {
+                Policy::on_warning_log_full();
+            }
+        } else if (Category == LogCategory::Error) {
+            if (!runtime_error_asserted) {
+                first_runtime_error_cause = new_entry;
+                runtime_error_asserted = true;
+            }
+            Policy::on_runtime_error();
+        }
+    }
+
+    std::uint32_t get_current_size() const
+    {
+        return current_size;
+    }
+
+    std::uint32_t get_call_count() const
+    {
+        return call_count;
+    }
+
+    bool is_full() const
+    {
+        return current_size == Capacity;
+    }
+
+    bool is_runtime_error_asserted() const
+    {
+        return runtime_error_asserted;
+    }
+
+    /* entry_index 0 is the oldest entry still in the log */
+    log_entry get_entry_at_index(std::uint32_t entry_index) const
+    {
+        const std::uint32_t oldest_entry_index{wrap_index(head + Capacity - current_size)};
+        return log_entries[wrap_index(oldest_entry_index + entry_index)];
+    }
+
+    log_entry get_first_runtime_error_cause() const
+    {
+        return first_runtime_error_cause;
+    }
+
+    void printf_log() const
+    {
+        for (std::uint32_t i{0u}; i < current_size; i++) {
+            print_log_entry(get_entry_at_index(i));
+        }
+    }
+
+    void printf_first_runtime_error_entry() const
+    {
+        if (runtime_error_asserted) {
+            print_log_entry(first_runtime_error_cause);
+        }
+    }
+
+    void reset()
+    {
+        *this = RuntimeLog{};
+    }
+
+private:
+    static constexpr std::uint32_t wrap_index(std::uint32_t index)
+    {
+        return CAPACITY_IS_POWER_OF_TWO ? (index & (Capacity - 1u)) : (index % Capacity);
+    }
+
+    log_entry log_entries[Capacity]{};
+    std::uint32_t head{0u};
+    std::uint32_t current_size{0u};
+    std::uint32_t call_count{0u};
+    bool runtime_error_asserted{false};
+    log_entry first_runtime_error_cause{};
+};
+
+template <std::uint32_t Capacity, typename Policy = NoHandlerPolicy>
+using TelemetryLog = RuntimeLog<Capacity, LogCategory::Telemetry, Policy>;
+
+template <std::uint32_t Capacity, typename Policy = NoHandlerPolicy>
+using WarningLog = RuntimeLog<Capacity, LogCategory::Warning, Policy>;
+
+template <std::uint32_t Capacity, typename Policy = NoHandlerPolicy>
+using ErrorLog = RuntimeLog<Capacity, LogCategory::Error, Policy>;
+
+} // namespace runtime_diagnostics
+
+#endif /* RUNTIME_LOG_HPP_ */
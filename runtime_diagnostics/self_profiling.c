@@ -0,0 +1,104 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : self_profiling.c                                      */
+/*                                                                            */
+/* Cycle count totals and log2 histograms of the library's own overhead       */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "self_profiling_probes.h"
+
+/*----------------------------------------------------------------------------*/
+/*                         Private Function Prototypes                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t get_histogram_bucket(uint32_t cycles);
+
+/*----------------------------------------------------------------------------*/
+/*                               Private Globals                              */
+/*----------------------------------------------------------------------------*/
+const char *profiling_probe_names_array[PROFILING_PROBES_COUNT] = {
+        "telemetry", "warning", "error", "warning handler", "error handler", "log dump"};
+
+uint32_t (*profiling_cycle_counter)(void) = NULL;
+struct profiling_statistics profiling_statistics_array[PROFILING_PROBES_COUNT] = {{0}};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+void set_profiling_cycle_counter(uint32_t (*cycle_counter)(void))
+{
+    profiling_cycle_counter = cycle_counter;
+}
+
+uint32_t start_profiling_sample(void)
+{
+    if (profiling_cycle_counter == NULL) {
+        return 0u;
+    }
+    return profiling_cycle_counter();
+}
+
+/* unsigned subtraction keeps samples right across one counter wraparound */
+void end_profiling_sample(enum profiling_probe probe, uint32_t start_cycles)
+{
+    if (profiling_cycle_counter == NULL) {
+        return;
+    }
+
+    uint32_t cycles = profiling_cycle_counter() - start_cycles;
+    struct profiling_statistics *stats = &profiling_statistics_array[probe];
+    stats->sample_count++;
+    stats->total_cycles += cycles;
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+    stats->histogram[get_histogram_bucket(cycles)]++;
+}
+
+void get_profiling_statistics(enum profiling_probe probe, struct profiling_statistics *stats)
+{
+    *stats = profiling_statistics_array[probe];
+}
+
+void printf_profiling_report(void)
+{
+    for (uint32_t i = 0u; i < PROFILING_PROBES_COUNT; i++) {
+        struct profiling_statistics *stats = &profiling_statistics_array[i];
+        printf("%s: samples %" PRIu32 ", total %" PRIu64 ", max %" PRIu32 ", histogram",
+               profiling_probe_names_array[i], stats->sample_count, stats->total_cycles,
+               stats->max_cycles);
+        for (uint32_t j = 0u; j < PROFILING_HISTOGRAM_BUCKETS; j++) {
+            if (stats->histogram[j] != 0u) {
+                printf(" [%" PRIu32 "+] %" PRIu32, (j == 0u) ? 0u : (1u << j),
+                       stats->histogram[j]);
+            }
+        }
+        printf("\r\n");
+    }
+}
+
+void reset_self_profiling(void)
+{
+    profiling_cycle_counter = NULL;
+    memset(profiling_statistics_array, 0, sizeof(profiling_statistics_array));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                        Private Function Definitions                        */
+/*----------------------------------------------------------------------------*/
+static uint32_t get_histogram_bucket(uint32_t cycles)
+{
+    uint32_t bucket = 0u;
+    while (cycles > 1u) {
+        cycles >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
@@ -0,0 +1,54 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : self_profiling.h                                      */
+/*                                                                            */
+/* Interface to cycle counts of the library's own overhead (opt-in)           */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef SELF_PROFILING_H_
+#define SELF_PROFILING_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+enum profiling_probe
+{
+    TELEMETRY_PROFILING_PROBE = 0,
+    WARNING_PROFILING_PROBE,
+    ERROR_PROFILING_PROBE,
+    WARNING_HANDLER_PROFILING_PROBE,
+    ERROR_HANDLER_PROFILING_PROBE,
+    LOG_DUMP_PROFILING_PROBE,
+    PROFILING_PROBES_COUNT
+};
+
+enum
+{
+    /* bucket i counts samples of [2^i, 2^(i+1)) cycles- bucket 0 also counts 0 */
+    PROFILING_HISTOGRAM_BUCKETS = 32
+};
+
+struct profiling_statistics {
+    uint32_t sample_count;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    uint32_t histogram[PROFILING_HISTOGRAM_BUCKETS];
+};
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+/* only built w/ ENABLE_RUNTIME_DIAGNOSTICS_SELF_PROFILING */
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+/* e.g. a DWT CYCCNT or COUNT register read- nothing is sampled until it's set */
+void set_profiling_cycle_counter(uint32_t (*cycle_counter)(void));
+
+void get_profiling_statistics(enum profiling_probe probe, struct profiling_statistics *stats);
+void printf_profiling_report(void);
+#endif
+
+#endif /* SELF_PROFILING_H_ */
@@ -0,0 +1,39 @@
+/*-------------------------------- FILE INFO ---------------------------------*/
+/* Filename           : self_profiling_probes.h                               */
+/*                                                                            */
+/* Probes placed in the library's own code (private header)                   */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+#ifndef SELF_PROFILING_PROBES_H_
+#define SELF_PROFILING_PROBES_H_
+
+/*----------------------------------------------------------------------------*/
+/*                               Include Files                                */
+/*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "self_profiling.h"
+
+/*----------------------------------------------------------------------------*/
+/*                             Public Definitions                             */
+/*----------------------------------------------------------------------------*/
+/* probes compile to nothing unless built w/ ENABLE_RUNTIME_DIAGNOSTICS_SELF_PROFILING */
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+#define START_PROFILING_SAMPLE(start_cycles) uint32_t start_cycles = start_profiling_sample()
+#define END_PROFILING_SAMPLE(probe, start_cycles) end_profiling_sample((probe), (start_cycles))
+#else
+#define START_PROFILING_SAMPLE(start_cycles)
+#define END_PROFILING_SAMPLE(probe, start_cycles) ((void)(probe))
+#endif
+
+/*----------------------------------------------------------------------------*/
+/*                         Public Function Prototypes                         */
+/*----------------------------------------------------------------------------*/
+#if defined(RUNTIME_DIAGNOSTICS_SELF_PROFILING)
+uint32_t start_profiling_sample(void);
+void end_profiling_sample(enum profiling_probe probe, uint32_t start_cycles);
+
+/* reset is for testing only */
+void reset_self_profiling(void);
+#endif
+
+#endif /* SELF_PROFILING_PROBES_H_ */
@@ -0,0 +1,151 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_handler_dispatch_thread.cpp                      */
+/*                                                                            */
+/* Test implementation for handler_dispatch.c's dispatch thread (linux only)  */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "handler_dispatch.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+std::atomic<uint32_t> thread_handler_calls{0u};
+std::atomic<bool> blocking_handler_entered{false};
+std::atomic<bool> blocking_handler_released{false};
+
+void thread_counting_handler(void)
+{
+    thread_handler_calls++;
+}
+
+void stopping_handler(void)
+{
+    stop_handler_dispatch_thread();
+    thread_handler_calls++;
+}
+
+void blocking_handler(void)
+{
+    thread_handler_calls++;
+    blocking_handler_entered = true;
+    while (!blocking_handler_released) {
+        std::this_thread::yield();
+    }
+}
+
+bool wait_for_thread_handler_calls(uint32_t expected_calls)
+{
+    for (uint32_t i{0u}; i < 1000u; i++) {
+        if (thread_handler_calls == expected_calls) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(HandlerDispatchThreadTest)
+{
+    void setup() override
+    {
+        reset_handler_dispatch();
+        thread_handler_calls = 0u;
+        blocking_handler_entered = false;
+        blocking_handler_released = false;
+    }
+
+    void teardown() override
+    {
+        reset_handler_dispatch();
+        thread_handler_calls = 0u;
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(HandlerDispatchThreadTest, DispatchThreadServicesDeferredHandlers)
+{
+    CHECK(start_handler_dispatch_thread());
+    LONGS_EQUAL(HANDLER_DISPATCH_DEFERRED, get_handler_dispatch_mode());
+
+    dispatch_handler(ERROR_HANDLER_EVENT, thread_counting_handler);
+    CHECK(wait_for_thread_handler_calls(1u));
+
+    stop_handler_dispatch_thread();
+}
+
+TEST(HandlerDispatchThreadTest, StoppingDispatchThreadRestoresMode)
+{
+    CHECK(start_handler_dispatch_thread());
+    stop_handler_dispatch_thread();
+    LONGS_EQUAL(HANDLER_DISPATCH_SYNCHRONOUS, get_handler_dispatch_mode());
+
+    // nothing services deferred events anymore, so they must run right away
+    dispatch_handler(WARNING_HANDLER_EVENT, thread_counting_handler);
+    LONGS_EQUAL(1u, thread_handler_calls);
+}
+
+TEST(HandlerDispatchThreadTest, StartingDispatchThreadTwiceKeepsOneThread)
+{
+    CHECK(start_handler_dispatch_thread());
+    CHECK(start_handler_dispatch_thread());
+    stop_handler_dispatch_thread();
+    LONGS_EQUAL(HANDLER_DISPATCH_SYNCHRONOUS, get_handler_dispatch_mode());
+}
+
+TEST(HandlerDispatchThreadTest, EventFromAnotherThreadRunsAfterRunningHandler)
+{
+    std::thread holder{[] { dispatch_handler(ERROR_HANDLER_EVENT, blocking_handler); }};
+    while (!blocking_handler_entered) {
+        std::this_thread::yield();
+    }
+
+    // the same event from another thread isn't re-entrancy- it's posted for the holder
+    dispatch_handler(ERROR_HANDLER_EVENT, thread_counting_handler);
+    LONGS_EQUAL(1u, thread_handler_calls);
+    CHECK(is_handler_event_pending(ERROR_HANDLER_EVENT));
+
+    blocking_handler_released = true;
+    holder.join();
+
+    LONGS_EQUAL(2u, thread_handler_calls);
+    CHECK_FALSE(is_handler_event_pending(ERROR_HANDLER_EVENT));
+    LONGS_EQUAL(1u, get_contended_handler_event_count());
+    LONGS_EQUAL(0u, get_suppressed_reentrant_handler_count());
+}
+
+TEST(HandlerDispatchThreadTest, DispatchThreadCanBeStoppedFromItsHandler)
+{
+    CHECK(start_handler_dispatch_thread());
+
+    // the dispatch thread can't join itself- it's detached instead
+    dispatch_handler(ERROR_HANDLER_EVENT, stopping_handler);
+    CHECK(wait_for_thread_handler_calls(1u));
+    LONGS_EQUAL(HANDLER_DISPATCH_SYNCHRONOUS, get_handler_dispatch_mode());
+
+    // and it can be started again right away
+    CHECK(start_handler_dispatch_thread());
+    dispatch_handler(WARNING_HANDLER_EVENT, thread_counting_handler);
+    CHECK(wait_for_thread_handler_calls(2u));
+    stop_handler_dispatch_thread();
+}
@@ -0,0 +1,19 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_main.cpp                                         */
+/*                                                                            */
+/* CppUTest runner for the linux only runtime_diagnostics tests               */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+#include <CppUTest/CommandLineTestRunner.h>
+
+/*============================================================================*/
+/*                                    Main                                    */
+/*============================================================================*/
+int main(int argc, char **argv)
+{
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
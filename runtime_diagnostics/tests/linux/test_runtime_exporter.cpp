@@ -0,0 +1,275 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_runtime_exporter.cpp                             */
+/*                                                                            */
+/* Test implementation for runtime_exporter.c (POSIX only)                    */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "runtime_diagnostics.h"
+#include "runtime_export_format.h"
+#include "runtime_exporter.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <array>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+struct decoded_entry {
+    uint32_t sequence;
+    uint32_t timestamp;
+    uint32_t fail_value;
+    uint8_t category;
+    std::string message;
+};
+
+struct decoded_frame {
+    uint32_t dropped_entry_count;
+    std::vector<decoded_entry> entries;
+};
+
+std::array<int, 2> socket_fds{-1, -1};
+
+uint32_t get_u32(const uint8_t *source)
+{
+    return static_cast<uint32_t>(source[0]) | (static_cast<uint32_t>(source[1]) << 8)
+           | (static_cast<uint32_t>(source[2]) << 16)
+           | (static_cast<uint32_t>(source[3]) << 24);
+}
+
+uint16_t get_u16(const uint8_t *source)
+{
+    return static_cast<uint16_t>(source[0] | (source[1] << 8));
+}
+
+std::vector<uint8_t> read_all_available(void)
+{
+    std::vector<uint8_t> received;
+    std::array<uint8_t, 4096> buffer{};
+    ssize_t read_size{0};
+    while ((read_size = read(socket_fds[1], buffer.data(), buffer.size())) > 0) {
+        received.insert(received.end(), buffer.begin(), buffer.begin() + read_size);
+    }
+    return received;
+}
+
+std::vector<decoded_frame> decode_frames(const std::vector<uint8_t> &stream)
+{
+    std::vector<decoded_frame> frames;
+    size_t frame_offset{0u};
+
+    while (frame_offset + EXPORT_FRAME_HEADER_SIZE <= stream.size()) {
+        const uint8_t *frame{&stream[frame_offset]};
+        const uint32_t frame_size{static_cast<uint32_t>(sizeof(uint32_t)) + get_u32(frame)};
+        LONGS_EQUAL(EXPORT_FRAME_MAGIC, get_u16(&frame[4]));
+        LONGS_EQUAL(EXPORT_FRAME_VERSION, frame[6]);
+        LONGS_EQUAL(static_cast<uint32_t>(getpid()), get_u32(&frame[8]));
+
+        decoded_frame decoded{get_u32(&frame[12]), {}};
+        uint32_t offset{EXPORT_FRAME_HEADER_SIZE};
+        for (uint16_t i{0u}; i < get_u16(&frame[16]); i++) {
+            const uint8_t *entry{&frame[offset]};
+            const char *message{
+                    reinterpret_cast<const char *>(&entry[EXPORT_ENTRY_HEADER_SIZE])};
+            decoded.entries.push_back({get_u32(&entry[0]), get_u32(&entry[4]),
+                                       get_u32(&entry[8]), entry[12],
+                                       std::string(message, entry[13])});
+            offset += EXPORT_ENTRY_HEADER_SIZE + entry[13];
+        }
+        LONGS_EQUAL(frame_size, offset);
+
+        frames.push_back(decoded);
+        frame_offset += frame_size;
+    }
+    LONGS_EQUAL(stream.size(), frame_offset);
+    return frames;
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(RuntimeExporterTest)
+{
+    void setup() override
+    {
+        init_runtime_diagnostics();
+        CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, socket_fds.data()) == 0);
+        CHECK(fcntl(socket_fds[1], F_SETFL, O_NONBLOCK) == 0);
+    }
+
+    void teardown() override
+    {
+        stop_runtime_exporter();
+        close(socket_fds[0]);
+        close(socket_fds[1]);
+        deinit_runtime_diagnostics();
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(RuntimeExporterTest, PollWithoutNewEntriesSendsNothing)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    LONGS_EQUAL(0u, poll_runtime_exporter());
+    LONGS_EQUAL(0u, read_all_available().size());
+}
+
+TEST(RuntimeExporterTest, NewEntriesFromAllLogsAreSentInOneFrame)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    RUNTIME_WARNING(3, "some_file.c: warning msg", 4);
+    RUNTIME_ERROR(5, "some_file.c: error msg", 6);
+
+    LONGS_EQUAL(3u, poll_runtime_exporter());
+
+    const std::vector<decoded_frame> frames{decode_frames(read_all_available())};
+    LONGS_EQUAL(1u, frames.size());
+    LONGS_EQUAL(0u, frames[0].dropped_entry_count);
+    LONGS_EQUAL(3u, frames[0].entries.size());
+    LONGS_EQUAL(0u, frames[0].entries[0].category);
+    LONGS_EQUAL(1u, frames[0].entries[0].timestamp);
+    LONGS_EQUAL(2u, frames[0].entries[0].fail_value);
+    STRCMP_EQUAL("some_file.c: telemetry msg", frames[0].entries[0].message.c_str());
+    LONGS_EQUAL(2u, frames[0].entries[2].category);
+    STRCMP_EQUAL("some_file.c: error msg", frames[0].entries[2].message.c_str());
+}
+
+TEST(RuntimeExporterTest, EntriesAreOnlySentOnce)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(1u, poll_runtime_exporter());
+    RUNTIME_TELEMETRY(3, "some_file.c: telemetry msg", 4);
+    LONGS_EQUAL(1u, poll_runtime_exporter());
+
+    const std::vector<decoded_frame> frames{decode_frames(read_all_available())};
+    LONGS_EQUAL(2u, frames.size());
+    LONGS_EQUAL(0u, frames[0].entries[0].sequence);
+    LONGS_EQUAL(1u, frames[1].entries[0].sequence);
+}
+
+TEST(RuntimeExporterTest, EntriesAlreadyInLogsAreSentOnStart)
+{
+    RUNTIME_WARNING(1, "some_file.c: warning msg", 2);
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    LONGS_EQUAL(1u, poll_runtime_exporter());
+}
+
+TEST(RuntimeExporterTest, EntriesAfterInitAreSentFromSequenceZero)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(1u, poll_runtime_exporter());
+
+    init_runtime_diagnostics();
+    RUNTIME_TELEMETRY(3, "some_file.c: telemetry msg", 4);
+    RUNTIME_TELEMETRY(5, "some_file.c: telemetry msg", 6);
+    LONGS_EQUAL(2u, poll_runtime_exporter());
+
+    const std::vector<decoded_frame> frames{decode_frames(read_all_available())};
+    LONGS_EQUAL(2u, frames.size());
+    LONGS_EQUAL(2u, frames[1].entries.size());
+    LONGS_EQUAL(0u, frames[1].entries[0].sequence);
+    LONGS_EQUAL(3u, frames[1].entries[0].timestamp);
+    LONGS_EQUAL(1u, frames[1].entries[1].sequence);
+}
+
+TEST(RuntimeExporterTest, OverwrittenEntriesAreCountedAsDropped)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    // overflowing by arbitrary prime number
+    for (uint32_t i{0u}; i < ERROR_LOG_CAPACITY + 107u; i++) {
+        RUNTIME_ERROR(i, "some_file.c: error msg", i);
+    }
+
+    LONGS_EQUAL(ERROR_LOG_CAPACITY, poll_runtime_exporter());
+    LONGS_EQUAL(107u, get_exporter_dropped_entry_count());
+
+    const std::vector<decoded_frame> frames{decode_frames(read_all_available())};
+    LONGS_EQUAL(107u, frames[0].dropped_entry_count);
+    LONGS_EQUAL(107u, frames[0].entries[0].sequence);
+}
+
+TEST(RuntimeExporterTest, SlowCollectorNeverBlocksPoll)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+
+    // nobody reads, so the socket buffer fills and polls have to give up
+    for (uint32_t i{0u}; i < 20000u; i++) {
+        RUNTIME_TELEMETRY(i, "some_file.c: telemetry msg", i);
+        poll_runtime_exporter();
+    }
+
+    // once drained, the frame in flight completes and the next frame reports what was lost
+    std::vector<uint8_t> stream{read_all_available()};
+    CHECK(stream.size() > 0u);
+    poll_runtime_exporter();
+    poll_runtime_exporter();
+    const std::vector<uint8_t> rest{read_all_available()};
+    stream.insert(stream.end(), rest.begin(), rest.end());
+
+    const std::vector<decoded_frame> frames{decode_frames(stream)};
+    CHECK(get_exporter_dropped_entry_count() > 0u);
+    LONGS_EQUAL(get_exporter_dropped_entry_count(), frames.back().dropped_entry_count);
+}
+
+TEST(RuntimeExporterTest, MissingCollectorDropsEntries)
+{
+    CHECK(start_runtime_exporter("/nonexistent/runtime_collector.sock"));
+    CHECK_FALSE(is_runtime_exporter_connected());
+
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(0u, poll_runtime_exporter());
+    LONGS_EQUAL(1u, get_exporter_dropped_entry_count());
+}
+
+TEST(RuntimeExporterTest, ClosedCollectorDropsFrame)
+{
+    CHECK(start_runtime_exporter_on_fd(socket_fds[0]));
+    close(socket_fds[1]);
+    socket_fds[1] = -1;
+
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(0u, poll_runtime_exporter());
+    LONGS_EQUAL(1u, get_exporter_dropped_entry_count());
+    CHECK_FALSE(is_runtime_exporter_connected());
+}
+
+TEST(RuntimeExporterTest, ClosedPipeCollectorDropsFrameWithoutSigpipe)
+{
+    std::array<int, 2> pipe_fds{-1, -1};
+    CHECK(pipe(pipe_fds.data()) == 0);
+    close(pipe_fds[0]);
+    CHECK(start_runtime_exporter_on_fd(pipe_fds[1]));
+
+    // an unprotected write here would kill the test runner w/ SIGPIPE
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(0u, poll_runtime_exporter());
+    LONGS_EQUAL(1u, get_exporter_dropped_entry_count());
+    CHECK_FALSE(is_runtime_exporter_connected());
+
+    sigset_t pending_set;
+    sigpending(&pending_set);
+    LONGS_EQUAL(0, sigismember(&pending_set, SIGPIPE));
+    close(pipe_fds[1]);
+}
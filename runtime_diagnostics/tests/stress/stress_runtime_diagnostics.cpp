@@ -0,0 +1,736 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : stress_runtime_diagnostics.cpp                        */
+/*                                                                            */
+/* Randomized stress and model-checking harness for runtime_diagnostics       */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "payload_arena.h"
+#include "runtime_diagnostics.h"
+
+}
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+/*
+ * Usage: stress_runtime_diagnostics [seed] [operations] [producers]
+ *
+ *  1. model check- random RUNTIME_* calls, payload sizes, handler actions,
+ *     dispatch modes, polls and resets are mirrored on a reference model and
+ *     compared after every operation
+ *  2. multi-producer- producers serialize RUNTIME_* calls on one lock (the
+ *     core logs are single-producer) while deferred handlers run on the
+ *     dispatch thread; build w/ ENABLE_RUNTIME_DIAGNOSTICS_TSAN to check it
+ *  3. throughput and tail latency of every RUNTIME_* call during 1 and 2
+ */
+enum log_category
+{
+    TELEMETRY_LOG_INDEX = 0,
+    WARNING_LOG_INDEX,
+    ERROR_LOG_INDEX,
+    LOG_CATEGORIES_COUNT
+};
+
+enum handler_action
+{
+    HANDLER_COUNTS_ONLY = 0,
+    HANDLER_LOGS_TELEMETRY,
+    HANDLER_LOGS_WARNING,
+    HANDLER_LOGS_ERROR,
+    HANDLER_ACTIONS_COUNT
+};
+
+/* mirrors payload_log.c's record header, to model arena byte usage */
+struct payload_record_header_mirror {
+    uint32_t timestamp;
+    const char *fail_message;
+    uint8_t category;
+    uint8_t payload_size;
+};
+
+constexpr uint32_t DEFAULT_SEED{1u};
+constexpr uint32_t DEFAULT_OPERATIONS{200000u};
+constexpr uint32_t DEFAULT_PRODUCERS{4u};
+constexpr uint32_t PAYLOAD_CHECK_INTERVAL{64u};
+/* the library's mean and variance are doubles- a float's error would be ~1e-7 */
+constexpr double STATISTICS_RELATIVE_TOLERANCE{1e-9};
+constexpr uint32_t PAYLOAD_RECORD_OVERHEAD{PAYLOAD_ARENA_LENGTH_PREFIX_SIZE
+                                           + sizeof(payload_record_header_mirror)};
+
+constexpr const char *CALL_SITES[]{"stress.cpp: site a", "stress.cpp: site b",
+                                   "stress.cpp: site c", "stress.cpp: site d",
+                                   "stress.cpp: site e", "stress.cpp: site f"};
+constexpr uint32_t CALL_SITES_COUNT{sizeof(CALL_SITES) / sizeof(CALL_SITES[0])};
+constexpr const char *HANDLER_CALL_SITE{"stress.cpp: from handler"};
+
+const uint32_t log_capacities_array[LOG_CATEGORIES_COUNT]{TELEMETRY_LOG_CAPACITY,
+                                                          WARNING_LOG_CAPACITY, ERROR_LOG_CAPACITY};
+const char *category_names_array[LOG_CATEGORIES_COUNT]{"telemetry", "warning", "error"};
+
+void (*runtime_functions[LOG_CATEGORIES_COUNT])(uint32_t, const char *, uint32_t){
+        RUNTIME_TELEMETRY, RUNTIME_WARNING, RUNTIME_ERROR};
+void (*payload_functions[LOG_CATEGORIES_COUNT])(uint32_t, const char *, const void *, uint32_t){
+        RUNTIME_TELEMETRY_PAYLOAD, RUNTIME_WARNING_PAYLOAD, RUNTIME_ERROR_PAYLOAD};
+struct log_entry (*get_log_entry_functions[LOG_CATEGORIES_COUNT])(uint32_t){
+        get_telemetry_log_entry, get_warning_log_entry, get_error_log_entry};
+uint32_t (*get_log_current_size_functions[LOG_CATEGORIES_COUNT])(void){
+        get_telemetry_log_current_size, get_warning_log_current_size, get_error_log_current_size};
+uint32_t (*get_call_count_functions[LOG_CATEGORIES_COUNT])(void){
+        get_telemetry_call_count, get_warning_call_count, get_error_call_count};
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+void (*get_statistics_functions[LOG_CATEGORIES_COUNT])(struct running_statistics *){
+        get_telemetry_statistics, get_warning_statistics, get_error_statistics};
+#endif
+
+uint32_t failures_count{0u};
+
+/*============================================================================*/
+/*                               Reference Model                              */
+/*============================================================================*/
+struct model_payload_record {
+    uint32_t total_size;
+    std::vector<uint8_t> payload;
+};
+
+struct model_call_site {
+    const char *fail_message;
+    uint32_t event_count;
+};
+
+class RuntimeDiagnosticsModel
+{
+public:
+    void reset()
+    {
+        *this = RuntimeDiagnosticsModel{};
+    }
+
+    void runtime_call(log_category category, uint32_t timestamp, const char *fail_message,
+                      uint32_t fail_value)
+    {
+        std::deque<log_entry> &log{logs[category]};
+        log.push_back(log_entry{timestamp, fail_message, fail_value});
+        if (log.size() > log_capacities_array[category]) {
+            log.pop_front();
+        }
+        call_counts[category]++;
+        update_statistics(category, fail_message, fail_value);
+
+        if ((category == WARNING_LOG_INDEX) && is_full(WARNING_LOG_INDEX)
+            && warning_handler_set) {
+            dispatch(WARNING_HANDLER_EVENT);
+        } else if (category == ERROR_LOG_INDEX) {
+            if (!runtime_error_asserted) {
+                first_runtime_error_cause = log.back();
+                runtime_error_asserted = true;
+            }
+            if (error_handler_set) {
+                dispatch(ERROR_HANDLER_EVENT);
+            }
+        }
+    }
+
+    void payload_call(log_category category, uint32_t timestamp, const char *fail_message,
+                      uint32_t payload_size, const uint8_t *payload)
+    {
+        const uint32_t stored_size{std::min<uint32_t>(payload_size, PAYLOAD_MAX_SIZE)};
+        const uint32_t total_size{PAYLOAD_RECORD_OVERHEAD + stored_size};
+
+        payload_records.push_back(
+                {total_size, std::vector<uint8_t>(payload, payload + stored_size)});
+        payload_used_size += total_size;
+        while (payload_used_size > PAYLOAD_LOG_CAPACITY_BYTES) {
+            payload_used_size -= payload_records.front().total_size;
+            payload_records.pop_front();
+        }
+
+        runtime_call(category, timestamp, fail_message, stored_size);
+    }
+
+    void set_handler(handler_event event, handler_action action)
+    {
+        handler_actions[event] = action;
+        if (event == WARNING_HANDLER_EVENT) {
+            warning_handler_set = true;
+            if (is_full(WARNING_LOG_INDEX)) {
+                dispatch(WARNING_HANDLER_EVENT);
+            }
+        } else {
+            error_handler_set = true;
+            if (runtime_error_asserted) {
+                dispatch(ERROR_HANDLER_EVENT);
+            }
+        }
+    }
+
+    uint32_t poll()
+    {
+        if (!pending[WARNING_HANDLER_EVENT] && !pending[ERROR_HANDLER_EVENT]) {
+            return 0u;
+        }
+
+        const std::array<bool, HANDLER_EVENTS_COUNT> polled_events{pending};
+        pending.fill(false);
+        in_handler = true;
+        uint32_t handlers_called{0u};
+        for (uint32_t i{0u}; i < HANDLER_EVENTS_COUNT; i++) {
+            if (polled_events[i]) {
+                run_handler(static_cast<handler_event>(i));
+                handlers_called++;
+            }
+        }
+        in_handler = false;
+        running_event = HANDLER_EVENTS_COUNT;
+        return handlers_called;
+    }
+
+    bool is_full(log_category category) const
+    {
+        return logs[category].size() == log_capacities_array[category];
+    }
+
+    std::array<std::deque<log_entry>, LOG_CATEGORIES_COUNT> logs{};
+    std::array<uint32_t, LOG_CATEGORIES_COUNT> call_counts{};
+    std::array<uint32_t, LOG_CATEGORIES_COUNT> event_counts{};
+    std::array<uint32_t, LOG_CATEGORIES_COUNT> min_fail_values{};
+    std::array<uint32_t, LOG_CATEGORIES_COUNT> max_fail_values{};
+    std::array<long double, LOG_CATEGORIES_COUNT> mean_fail_values{};
+    std::array<long double, LOG_CATEGORIES_COUNT> sums_of_squared_deviations{};
+    std::vector<model_call_site> call_sites{};
+    std::deque<model_payload_record> payload_records{};
+    uint32_t payload_used_size{0u};
+
+    bool runtime_error_asserted{false};
+    log_entry first_runtime_error_cause{};
+
+    handler_dispatch_mode dispatch_mode{HANDLER_DISPATCH_SYNCHRONOUS};
+    std::array<handler_action, HANDLER_EVENTS_COUNT> handler_actions{};
+    std::array<uint32_t, HANDLER_EVENTS_COUNT> handler_calls{};
+    std::array<bool, HANDLER_EVENTS_COUNT> pending{};
+    bool warning_handler_set{false};
+    bool error_handler_set{false};
+    bool in_handler{false};
+    handler_event running_event{HANDLER_EVENTS_COUNT};
+    uint32_t coalesced_count{0u};
+    uint32_t suppressed_count{0u};
+
+private:
+    void update_statistics(log_category category, const char *fail_message, uint32_t fail_value)
+    {
+        if (event_counts[category] == 0u) {
+            min_fail_values[category] = fail_value;
+            max_fail_values[category] = fail_value;
+        }
+        min_fail_values[category] = std::min(min_fail_values[category], fail_value);
+        max_fail_values[category] = std::max(max_fail_values[category], fail_value);
+        event_counts[category]++;
+
+        /* Welford in long double, as a higher precision reference for the library's */
+        const long double delta{fail_value - mean_fail_values[category]};
+        mean_fail_values[category] += delta / event_counts[category];
+        sums_of_squared_deviations[category] += delta * (fail_value - mean_fail_values[category]);
+
+        for (model_call_site &call_site : call_sites) {
+            if (call_site.fail_message == fail_message) {
+                call_site.event_count++;
+                return;
+            }
+        }
+        call_sites.push_back({fail_message, 1u});
+    }
+
+    void dispatch(handler_event event)
+    {
+        if (dispatch_mode == HANDLER_DISPATCH_DEFERRED) {
+            if (pending[event]) {
+                coalesced_count++;
+            }
+            pending[event] = true;
+            return;
+        }
+
+        if (in_handler) {
+            if (running_event == event) {
+                suppressed_count++;
+            } else {
+                if (pending[event]) {
+                    coalesced_count++;
+                }
+                pending[event] = true;
+            }
+            return;
+        }
+        in_handler = true;
+        run_handler(event);
+        in_handler = false;
+        running_event = HANDLER_EVENTS_COUNT;
+        poll();
+    }
+
+    void run_handler(handler_event event)
+    {
+        running_event = event;
+        handler_calls[event]++;
+        switch (handler_actions[event]) {
+        case HANDLER_LOGS_TELEMETRY:
+            runtime_call(TELEMETRY_LOG_INDEX, 0u, HANDLER_CALL_SITE, event);
+            break;
+        case HANDLER_LOGS_WARNING:
+            runtime_call(WARNING_LOG_INDEX, 0u, HANDLER_CALL_SITE, event);
+            break;
+        case HANDLER_LOGS_ERROR:
+            runtime_call(ERROR_LOG_INDEX, 0u, HANDLER_CALL_SITE, event);
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+/*============================================================================*/
+/*                              Harness Handlers                              */
+/*============================================================================*/
+std::array<handler_action, HANDLER_EVENTS_COUNT> handler_actions{};
+std::array<std::atomic<uint32_t>, HANDLER_EVENTS_COUNT> handler_calls{};
+std::mutex producer_lock;
+bool handlers_take_producer_lock{false};
+
+void run_handler_action(handler_event event)
+{
+    handler_calls[event]++;
+
+    const handler_action action{handler_actions[event]};
+    if (action == HANDLER_COUNTS_ONLY) {
+        return;
+    }
+
+    const log_category category{action == HANDLER_LOGS_TELEMETRY ? TELEMETRY_LOG_INDEX
+                                : action == HANDLER_LOGS_WARNING ? WARNING_LOG_INDEX
+                                                                 : ERROR_LOG_INDEX};
+    if (handlers_take_producer_lock) {
+        std::lock_guard<std::mutex> guard{producer_lock};
+        runtime_functions[category](0u, HANDLER_CALL_SITE, event);
+    } else {
+        runtime_functions[category](0u, HANDLER_CALL_SITE, event);
+    }
+}
+
+void stress_warning_handler(void)
+{
+    run_handler_action(WARNING_HANDLER_EVENT);
+}
+
+void stress_error_handler(void)
+{
+    run_handler_action(ERROR_HANDLER_EVENT);
+}
+
+std::vector<std::vector<uint8_t>> formatted_payloads;
+
+void capturing_payload_formatter(const uint8_t *payload, uint32_t payload_size)
+{
+    formatted_payloads.emplace_back(payload, payload + payload_size);
+}
+
+/*============================================================================*/
+/*                                  Checking                                  */
+/*============================================================================*/
+#define EXPECT(condition, ...)                                                                \
+    do {                                                                                       \
+        if (!(condition)) {                                                                    \
+            failures_count++;                                                                  \
+            fprintf(stderr, "FAILED %s:%d (%s): ", __FILE__, __LINE__, #condition);            \
+            fprintf(stderr, __VA_ARGS__);                                                      \
+            fprintf(stderr, "\n");                                                             \
+        }                                                                                      \
+    } while (0)
+
+bool entries_are_equal(const log_entry &a, const log_entry &b)
+{
+    return (a.timestamp == b.timestamp) && (a.fail_message == b.fail_message)
+           && (a.fail_value == b.fail_value);
+}
+
+bool is_within_tolerance(double actual, long double expected)
+{
+    return std::fabs(actual - expected)
+           <= STATISTICS_RELATIVE_TOLERANCE * std::max(std::fabs(expected), 1.0L);
+}
+
+void check_logs_against_model(const RuntimeDiagnosticsModel &model, uint64_t operation)
+{
+    for (uint32_t category{0u}; category < LOG_CATEGORIES_COUNT; category++) {
+        const std::deque<log_entry> &log{model.logs[category]};
+        EXPECT(get_log_current_size_functions[category]() == log.size(),
+               "op %" PRIu64 " %s size", operation, category_names_array[category]);
+        EXPECT(get_call_count_functions[category]() == model.call_counts[category],
+               "op %" PRIu64 " %s call count", operation, category_names_array[category]);
+
+        for (uint32_t i{0u}; i < log.size(); i++) {
+            EXPECT(entries_are_equal(get_log_entry_functions[category](i), log[i]),
+                   "op %" PRIu64 " %s entry %" PRIu32, operation,
+                   category_names_array[category], i);
+        }
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+        struct running_statistics stats{};
+        get_statistics_functions[category](&stats);
+        EXPECT(stats.event_count == model.event_counts[category], "op %" PRIu64, operation);
+        EXPECT(stats.min_fail_value == model.min_fail_values[category], "op %" PRIu64, operation);
+        EXPECT(stats.max_fail_value == model.max_fail_values[category], "op %" PRIu64, operation);
+        EXPECT(is_within_tolerance(stats.mean_fail_value, model.mean_fail_values[category]),
+               "op %" PRIu64 " %s mean %f expected %Lf", operation,
+               category_names_array[category], stats.mean_fail_value,
+               model.mean_fail_values[category]);
+        const long double model_variance{
+                (model.event_counts[category] == 0u)
+                        ? 0.0L
+                        : model.sums_of_squared_deviations[category]
+                                  / model.event_counts[category]};
+        EXPECT(is_within_tolerance(get_running_statistics_variance(&stats), model_variance),
+               "op %" PRIu64 " %s variance %f expected %Lf", operation,
+               category_names_array[category], get_running_statistics_variance(&stats),
+               model_variance);
+#endif
+    }
+}
+
+void check_handlers_against_model(const RuntimeDiagnosticsModel &model, uint64_t operation)
+{
+    for (uint32_t i{0u}; i < HANDLER_EVENTS_COUNT; i++) {
+        EXPECT(handler_calls[i] == model.handler_calls[i], "op %" PRIu64 " handler %" PRIu32
+               " called %" PRIu32 " expected %" PRIu32, operation, i, handler_calls[i].load(),
+               model.handler_calls[i]);
+        EXPECT(is_handler_event_pending(static_cast<handler_event>(i)) == model.pending[i],
+               "op %" PRIu64 " handler %" PRIu32 " pending", operation, i);
+    }
+    EXPECT(get_coalesced_handler_event_count() == model.coalesced_count, "op %" PRIu64, operation);
+    EXPECT(get_suppressed_reentrant_handler_count() == model.suppressed_count, "op %" PRIu64,
+           operation);
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+    EXPECT(get_untracked_call_site_event_count() == 0u, "op %" PRIu64, operation);
+
+    for (const model_call_site &call_site : model.call_sites) {
+        struct running_statistics stats{};
+        EXPECT(get_call_site_statistics(call_site.fail_message, &stats)
+                       && (stats.event_count == call_site.event_count),
+               "op %" PRIu64 " call site %s", operation, call_site.fail_message);
+    }
+#endif
+}
+
+void check_payloads_against_model(const RuntimeDiagnosticsModel &model, uint64_t operation)
+{
+    EXPECT(get_payload_log_current_size() == model.payload_records.size(), "op %" PRIu64,
+           operation);
+
+    formatted_payloads.clear();
+    set_payload_formatter(capturing_payload_formatter);
+    /* freopen, then put the original descriptor back- stdout may be a pipe or file */
+    fflush(stdout);
+    const int standard_output{dup(fileno(stdout))};
+    EXPECT(freopen("/dev/null", "w", stdout) != nullptr, "op %" PRIu64, operation);
+    printf_payload_log();
+    fflush(stdout);
+    dup2(standard_output, fileno(stdout));
+    close(standard_output);
+
+    EXPECT(formatted_payloads.size() == model.payload_records.size(), "op %" PRIu64, operation);
+    for (uint32_t i{0u}; i < std::min(formatted_payloads.size(), model.payload_records.size());
+         i++) {
+        EXPECT(formatted_payloads[i] == model.payload_records[i].payload,
+               "op %" PRIu64 " payload %" PRIu32, operation, i);
+    }
+}
+
+/*============================================================================*/
+/*                                   Latency                                  */
+/*============================================================================*/
+class LatencyRecorder
+{
+public:
+    template <typename Function>
+    void measure(Function &&function)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        function();
+        const auto end{std::chrono::steady_clock::now()};
+        samples_ns.push_back(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    void merge(const LatencyRecorder &other)
+    {
+        samples_ns.insert(samples_ns.end(), other.samples_ns.begin(), other.samples_ns.end());
+    }
+
+    double get_measured_seconds() const
+    {
+        uint64_t total_ns{0u};
+        for (uint32_t sample_ns : samples_ns) {
+            total_ns += sample_ns;
+        }
+        return static_cast<double>(total_ns) * 1e-9;
+    }
+
+    void printf_report(const char *name, double elapsed_seconds)
+    {
+        if (samples_ns.empty()) {
+            return;
+        }
+
+        std::sort(samples_ns.begin(), samples_ns.end());
+        printf("%s: %zu calls, %.0f calls/s, p50 %" PRIu32 " ns, p99 %" PRIu32
+               " ns, p999 %" PRIu32 " ns, max %" PRIu32 " ns\n",
+               name, samples_ns.size(), static_cast<double>(samples_ns.size()) / elapsed_seconds,
+               percentile(0.50), percentile(0.99), percentile(0.999), samples_ns.back());
+    }
+
+private:
+    uint32_t percentile(double fraction) const
+    {
+        const double last_index{static_cast<double>(samples_ns.size() - 1)};
+        const size_t index{static_cast<size_t>(fraction * last_index)};
+        return samples_ns[index];
+    }
+
+    std::vector<uint32_t> samples_ns;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*============================================================================*/
+/*                               Stress Phases                                */
+/*============================================================================*/
+void reset_harness_handlers(void)
+{
+    handler_actions.fill(HANDLER_COUNTS_ONLY);
+    for (std::atomic<uint32_t> &calls : handler_calls) {
+        calls = 0u;
+    }
+}
+
+void run_model_check_phase(uint32_t seed, uint32_t operations)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<uint32_t> any_value{};
+    std::uniform_int_distribution<uint32_t> percent{0u, 99u};
+    std::uniform_int_distribution<uint32_t> payload_size{0u, PAYLOAD_MAX_SIZE + 8u};
+    std::array<uint8_t, PAYLOAD_MAX_SIZE + 8u> payload{};
+    std::array<LatencyRecorder, LOG_CATEGORIES_COUNT> latencies{};
+    RuntimeDiagnosticsModel model;
+    uint32_t timestamp{0u};
+
+    init_runtime_diagnostics();
+    reset_harness_handlers();
+    const auto start{std::chrono::steady_clock::now()};
+
+    for (uint64_t operation{0u}; operation < operations; operation++) {
+        const uint32_t choice{percent(random)};
+        const log_category category{static_cast<log_category>(any_value(random) % 3u)};
+        const char *call_site{CALL_SITES[any_value(random) % CALL_SITES_COUNT]};
+        timestamp += any_value(random) % 100u;
+
+        if (choice < 80u) {
+            // biased towards small values, w/ the occasional extreme
+            const uint32_t fail_value{(percent(random) < 5u) ? any_value(random)
+                                                             : any_value(random) % 1000u};
+            latencies[category].measure(
+                    [&] { runtime_functions[category](timestamp, call_site, fail_value); });
+            model.runtime_call(category, timestamp, call_site, fail_value);
+        } else if (choice < 88u) {
+            const uint32_t size{payload_size(random)};
+            for (uint8_t &byte : payload) {
+                byte = static_cast<uint8_t>(any_value(random));
+            }
+            payload_functions[category](timestamp, call_site, payload.data(), size);
+            model.payload_call(category, timestamp, call_site, size, payload.data());
+        } else if (choice < 92u) {
+            const handler_event event{static_cast<handler_event>(any_value(random) % 2u)};
+            handler_actions[event] = static_cast<handler_action>(any_value(random)
+                                                                 % HANDLER_ACTIONS_COUNT);
+            if (event == WARNING_HANDLER_EVENT) {
+                set_warning_handler(stress_warning_handler);
+            } else {
+                set_error_handler(stress_error_handler);
+            }
+            model.set_handler(event, handler_actions[event]);
+        } else if (choice < 95u) {
+            const handler_dispatch_mode mode{(percent(random) < 50u)
+                                                     ? HANDLER_DISPATCH_SYNCHRONOUS
+                                                     : HANDLER_DISPATCH_DEFERRED};
+            set_handler_dispatch_mode(mode);
+            model.dispatch_mode = mode;
+        } else if (choice < 99u) {
+            const uint32_t handlers_called{poll_deferred_handlers()};
+            EXPECT(handlers_called == model.poll(), "op %" PRIu64 " poll", operation);
+        } else {
+            init_runtime_diagnostics();
+            reset_harness_handlers();
+            model.reset();
+        }
+
+        check_logs_against_model(model, operation);
+        check_handlers_against_model(model, operation);
+        if ((operation % PAYLOAD_CHECK_INTERVAL) == 0u) {
+            check_payloads_against_model(model, operation);
+        }
+        if (failures_count > 0u) {
+            fprintf(stderr, "model check stopped at op %" PRIu64 " (seed %" PRIu32 ")\n",
+                    operation, seed);
+            return;
+        }
+    }
+
+    // model checking dominates wall time, so throughput is over time spent inside the calls
+    printf("model check: %" PRIu32 " operations, seed %" PRIu32 ", %.2f s\n", operations, seed,
+           seconds_since(start));
+    for (uint32_t category{0u}; category < LOG_CATEGORIES_COUNT; category++) {
+        latencies[category].printf_report(category_names_array[category],
+                                          latencies[category].get_measured_seconds());
+    }
+}
+
+struct ordered_call {
+    log_category category;
+    log_entry entry;
+};
+
+void run_multi_producer_phase(uint32_t seed, uint32_t operations, uint32_t producers)
+{
+    std::vector<ordered_call> ordered_calls;
+    std::vector<LatencyRecorder> latencies(producers);
+    std::vector<std::thread> producer_threads;
+
+    init_runtime_diagnostics();
+    reset_harness_handlers();
+    handler_actions[WARNING_HANDLER_EVENT] = HANDLER_LOGS_TELEMETRY;
+    handler_actions[ERROR_HANDLER_EVENT] = HANDLER_LOGS_TELEMETRY;
+    set_warning_handler(stress_warning_handler);
+    set_error_handler(stress_error_handler);
+    handlers_take_producer_lock = true;
+    ordered_calls.reserve(2u * operations);
+    EXPECT(start_handler_dispatch_thread(), "dispatch thread did not start");
+
+    const auto start{std::chrono::steady_clock::now()};
+    for (uint32_t producer{0u}; producer < producers; producer++) {
+        producer_threads.emplace_back([&, producer] {
+            std::mt19937 random{seed + producer + 1u};
+            const uint32_t producer_operations{operations / producers};
+
+            for (uint32_t i{0u}; i < producer_operations; i++) {
+                const log_category category{static_cast<log_category>(random() % 3u)};
+                const log_entry entry{producer, CALL_SITES[producer % CALL_SITES_COUNT], i};
+
+                latencies[producer].measure([&] {
+                    std::lock_guard<std::mutex> guard{producer_lock};
+                    ordered_calls.push_back({category, entry});
+                    runtime_functions[category](entry.timestamp, entry.fail_message,
+                                                entry.fail_value);
+                });
+            }
+        });
+    }
+    for (std::thread &producer_thread : producer_threads) {
+        producer_thread.join();
+    }
+    stop_handler_dispatch_thread();
+    const double elapsed_seconds{seconds_since(start)};
+    handlers_take_producer_lock = false;
+
+    // replay the lock order on a model w/o handlers, then account for handler telemetry
+    RuntimeDiagnosticsModel model;
+    uint32_t handler_posts{0u};
+    for (const ordered_call &call : ordered_calls) {
+        model.runtime_call(call.category, call.entry.timestamp, call.entry.fail_message,
+                           call.entry.fail_value);
+        if ((call.category == ERROR_LOG_INDEX)
+            || ((call.category == WARNING_LOG_INDEX) && model.is_full(WARNING_LOG_INDEX))) {
+            handler_posts++;
+        }
+    }
+
+    const uint32_t handlers_called{handler_calls[WARNING_HANDLER_EVENT]
+                                   + handler_calls[ERROR_HANDLER_EVENT]};
+    EXPECT(handlers_called + get_coalesced_handler_event_count() == handler_posts,
+           "%" PRIu32 " handler calls + %" PRIu32 " coalesced != %" PRIu32 " posts",
+           handlers_called, get_coalesced_handler_event_count(), handler_posts);
+    EXPECT(get_telemetry_call_count() == model.call_counts[TELEMETRY_LOG_INDEX] + handlers_called,
+           "telemetry call count");
+    EXPECT(get_warning_call_count() == model.call_counts[WARNING_LOG_INDEX], "warning calls");
+    EXPECT(get_error_call_count() == model.call_counts[ERROR_LOG_INDEX], "error calls");
+
+    // handler telemetry interleaves unpredictably, so only check the other logs entry by entry
+    for (uint32_t category{WARNING_LOG_INDEX}; category < LOG_CATEGORIES_COUNT; category++) {
+        const std::deque<log_entry> &log{model.logs[category]};
+        EXPECT(get_log_current_size_functions[category]() == log.size(), "%s size",
+               category_names_array[category]);
+        for (uint32_t i{0u}; i < log.size(); i++) {
+            EXPECT(entries_are_equal(get_log_entry_functions[category](i), log[i]),
+                   "%s entry %" PRIu32, category_names_array[category], i);
+        }
+    }
+
+    LatencyRecorder all_latencies;
+    for (const LatencyRecorder &producer_latencies : latencies) {
+        all_latencies.merge(producer_latencies);
+    }
+    printf("multi-producer: %" PRIu32 " producers, %" PRIu32 " handler calls, %" PRIu32
+           " coalesced\n",
+           producers, handlers_called, get_coalesced_handler_event_count());
+    all_latencies.printf_report("locked RUNTIME_*", elapsed_seconds);
+}
+
+/*============================================================================*/
+/*                                    Main                                    */
+/*============================================================================*/
+int main(int argc, char *argv[])
+{
+    const uint32_t seed{(argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 0))
+                                   : DEFAULT_SEED};
+    const uint32_t operations{(argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 0))
+                                         : DEFAULT_OPERATIONS};
+    const uint32_t producers{(argc > 3) ? static_cast<uint32_t>(strtoul(argv[3], nullptr, 0))
+                                        : DEFAULT_PRODUCERS};
+
+    run_model_check_phase(seed, operations);
+    if (failures_count == 0u) {
+        run_multi_producer_phase(seed, operations, std::max(producers, 1u));
+    }
+    deinit_runtime_diagnostics();
+
+    if (failures_count > 0u) {
+        fprintf(stderr, "%" PRIu32 " failures\n", failures_count);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
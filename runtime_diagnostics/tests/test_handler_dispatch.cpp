@@ -0,0 +1,174 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_handler_dispatch.cpp                             */
+/*                                                                            */
+/* Test implementation for handler_dispatch.c                                 */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "handler_dispatch.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+std::atomic<uint32_t> counting_handler_calls{0u};
+uint32_t reentrant_handler_calls{0u};
+std::string handler_call_order{};
+
+void counting_handler(void)
+{
+    counting_handler_calls++;
+}
+
+void reentrant_handler(void)
+{
+    reentrant_handler_calls++;
+    dispatch_handler(ERROR_HANDLER_EVENT, reentrant_handler);
+}
+
+void error_handler_in_order(void)
+{
+    handler_call_order += "error ";
+}
+
+void warning_handler_raising_error(void)
+{
+    dispatch_handler(ERROR_HANDLER_EVENT, error_handler_in_order);
+    handler_call_order += "warning ";
+}
+
+void polling_handler(void)
+{
+    counting_handler_calls++;
+    LONGS_EQUAL(0u, poll_deferred_handlers());
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(HandlerDispatchTest)
+{
+    void setup() override
+    {
+        reset_handler_dispatch();
+        counting_handler_calls = 0u;
+        reentrant_handler_calls = 0u;
+        handler_call_order.clear();
+    }
+
+    void teardown() override
+    {
+        reset_handler_dispatch();
+        counting_handler_calls = 0u;
+        reentrant_handler_calls = 0u;
+        handler_call_order.clear();
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(HandlerDispatchTest, DefaultModeIsSynchronous)
+{
+    LONGS_EQUAL(HANDLER_DISPATCH_SYNCHRONOUS, get_handler_dispatch_mode());
+}
+
+TEST(HandlerDispatchTest, SynchronousDispatchCallsHandlerImmediately)
+{
+    dispatch_handler(WARNING_HANDLER_EVENT, counting_handler);
+    LONGS_EQUAL(1u, counting_handler_calls);
+    CHECK_FALSE(is_handler_event_pending(WARNING_HANDLER_EVENT));
+}
+
+TEST(HandlerDispatchTest, DeferredDispatchWaitsForPoll)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+
+    LONGS_EQUAL(0u, counting_handler_calls);
+    CHECK(is_handler_event_pending(ERROR_HANDLER_EVENT));
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    LONGS_EQUAL(1u, counting_handler_calls);
+    CHECK_FALSE(is_handler_event_pending(ERROR_HANDLER_EVENT));
+}
+
+TEST(HandlerDispatchTest, PendingEventsAreCoalesced)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    LONGS_EQUAL(1u, counting_handler_calls);
+    LONGS_EQUAL(2u, get_coalesced_handler_event_count());
+}
+
+TEST(HandlerDispatchTest, DifferentEventsAreNotCoalesced)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(WARNING_HANDLER_EVENT, counting_handler);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+
+    LONGS_EQUAL(2u, poll_deferred_handlers());
+    LONGS_EQUAL(0u, get_coalesced_handler_event_count());
+}
+
+TEST(HandlerDispatchTest, SynchronousReentrantDispatchIsSuppressed)
+{
+    dispatch_handler(ERROR_HANDLER_EVENT, reentrant_handler);
+    LONGS_EQUAL(1u, reentrant_handler_calls);
+    LONGS_EQUAL(1u, get_suppressed_reentrant_handler_count());
+}
+
+TEST(HandlerDispatchTest, DeferredReentrantDispatchRunsOnNextPoll)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(ERROR_HANDLER_EVENT, reentrant_handler);
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    LONGS_EQUAL(1u, reentrant_handler_calls);
+    CHECK(is_handler_event_pending(ERROR_HANDLER_EVENT));
+}
+
+TEST(HandlerDispatchTest, PollFromHandlerDoesNothing)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(WARNING_HANDLER_EVENT, polling_handler);
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    LONGS_EQUAL(1u, counting_handler_calls);
+}
+
+TEST(HandlerDispatchTest, SynchronousDispatchOfOtherEventRunsAfterHandler)
+{
+    dispatch_handler(WARNING_HANDLER_EVENT, warning_handler_raising_error);
+
+    STRCMP_EQUAL("warning error ", handler_call_order.c_str());
+    CHECK_FALSE(is_handler_event_pending(ERROR_HANDLER_EVENT));
+    LONGS_EQUAL(0u, get_suppressed_reentrant_handler_count());
+}
+
+TEST(HandlerDispatchTest, EventsLeftPendingRunOnNextSynchronousDispatch)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    dispatch_handler(ERROR_HANDLER_EVENT, counting_handler);
+    set_handler_dispatch_mode(HANDLER_DISPATCH_SYNCHRONOUS);
+
+    dispatch_handler(WARNING_HANDLER_EVENT, counting_handler);
+    LONGS_EQUAL(2u, counting_handler_calls);
+    CHECK_FALSE(is_handler_event_pending(ERROR_HANDLER_EVENT));
+}
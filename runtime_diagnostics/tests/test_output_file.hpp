@@ -0,0 +1,41 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_output_file.hpp                                  */
+/*                                                                            */
+/* Shared helpers for tests that check printf output through a file           */
+/*                                                                            */
+/*============================================================================*/
+#ifndef TEST_OUTPUT_FILE_HPP_
+#define TEST_OUTPUT_FILE_HPP_
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+#include <CppUTest/TestHarness.h>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+inline void printf_to_output_file(const char *output_file, void (*printf_function)(void))
+{
+    CHECK(freopen(output_file, "w+", stdout) != nullptr);
+    printf_function();
+    fflush(stdout);
+    freopen("CON", "w", stdout);
+}
+
+inline void check_output_file_contents(const char *output_file, const char *expected)
+{
+    std::array<char, 1024> contents{};
+    FILE *file{fopen(output_file, "rb")};
+    CHECK(file != nullptr);
+    const size_t read{fread(contents.data(), 1, contents.size() - 1, file)};
+    fclose(file);
+
+    LONGS_EQUAL(std::strlen(expected), read);
+    STRCMP_EQUAL(expected, contents.data());
+}
+
+#endif /* TEST_OUTPUT_FILE_HPP_ */
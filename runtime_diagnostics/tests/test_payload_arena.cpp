@@ -0,0 +1,137 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_payload_arena.cpp                                */
+/*                                                                            */
+/* Test implementation for payload_arena.c                                    */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "payload_arena.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+constexpr uint32_t TEST_ARENA_CAPACITY{32u};
+
+std::array<uint8_t, TEST_ARENA_CAPACITY> test_arena_bytes{};
+struct payload_arena test_arena{test_arena_bytes.data(), TEST_ARENA_CAPACITY, 0, 0, 0, 0};
+
+// records are a 1 byte header followed by `size` bytes all set to `value`
+bool append_test_record(uint8_t value, uint32_t size)
+{
+    std::array<uint8_t, TEST_ARENA_CAPACITY> payload{};
+    payload.fill(value);
+    return append_payload_arena_record(&test_arena, &value, 1u, payload.data(), size);
+}
+
+void check_test_record(uint32_t *offset, uint8_t value, uint32_t size)
+{
+    std::array<uint8_t, TEST_ARENA_CAPACITY> record{};
+    LONGS_EQUAL(1u + size, read_payload_arena_record(&test_arena, offset, record.data(),
+                                                     record.size()));
+    for (uint32_t i{0u}; i < 1u + size; i++) {
+        LONGS_EQUAL(value, record[i]);
+    }
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(PayloadArenaTest)
+{
+    void setup() override
+    {
+        reset_payload_arena(&test_arena);
+    }
+
+    void teardown() override
+    {
+        reset_payload_arena(&test_arena);
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(PayloadArenaTest, ArenaInitiallyHasNoRecords)
+{
+    LONGS_EQUAL(0u, test_arena.record_count);
+    LONGS_EQUAL(0u, test_arena.used_size);
+}
+
+TEST(PayloadArenaTest, RecordsAreReadBackInOrder)
+{
+    CHECK(append_test_record(0x11, 3u));
+    CHECK(append_test_record(0x22, 0u));
+    CHECK(append_test_record(0x33, 5u));
+
+    uint32_t offset{test_arena.tail};
+    check_test_record(&offset, 0x11, 3u);
+    check_test_record(&offset, 0x22, 0u);
+    check_test_record(&offset, 0x33, 5u);
+}
+
+TEST(PayloadArenaTest, UsedSizeIncludesLengthPrefix)
+{
+    CHECK(append_test_record(0x11, 3u));
+    LONGS_EQUAL(PAYLOAD_ARENA_LENGTH_PREFIX_SIZE + 4u, test_arena.used_size);
+}
+
+TEST(PayloadArenaTest, OldestRecordsAreDroppedToMakeRoom)
+{
+    // 3 records of 10 bytes fill 30 of 32 bytes
+    CHECK(append_test_record(0x11, 7u));
+    CHECK(append_test_record(0x22, 7u));
+    CHECK(append_test_record(0x33, 7u));
+    CHECK(append_test_record(0x44, 7u));
+
+    LONGS_EQUAL(3u, test_arena.record_count);
+    uint32_t offset{test_arena.tail};
+    check_test_record(&offset, 0x22, 7u);
+    check_test_record(&offset, 0x33, 7u);
+    check_test_record(&offset, 0x44, 7u);
+}
+
+TEST(PayloadArenaTest, RecordsWrapAroundArenaEnd)
+{
+    // arbitrary prime sized records land on every offset eventually
+    for (uint8_t i{0u}; i < 50u; i++) {
+        CHECK(append_test_record(i, 6u));
+    }
+
+    const uint32_t kept{test_arena.record_count};
+    uint32_t offset{test_arena.tail};
+    for (uint32_t i{50u - kept}; i < 50u; i++) {
+        check_test_record(&offset, static_cast<uint8_t>(i), 6u);
+    }
+}
+
+TEST(PayloadArenaTest, RecordLargerThanArenaIsRejected)
+{
+    CHECK(append_test_record(0x11, 3u));
+    CHECK_FALSE(append_test_record(0x22, TEST_ARENA_CAPACITY));
+    LONGS_EQUAL(1u, test_arena.record_count);
+}
+
+TEST(PayloadArenaTest, ReadIsTruncatedToRecordCapacity)
+{
+    CHECK(append_test_record(0x11, 7u));
+
+    std::array<uint8_t, 4> record{};
+    uint32_t offset{test_arena.tail};
+    LONGS_EQUAL(8u, read_payload_arena_record(&test_arena, &offset, record.data(), record.size()));
+    LONGS_EQUAL(test_arena.head, offset);
+}
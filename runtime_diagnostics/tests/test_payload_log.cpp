@@ -0,0 +1,176 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_payload_log.cpp                                  */
+/*                                                                            */
+/* Test implementation for payload_log.c                                      */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "payload_log.h"
+#include "runtime_diagnostics.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "test_output_file.hpp"
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+constexpr const char *PAYLOAD_TEST_OUTPUT_FILE{"payload_test_output.txt"};
+
+std::array<uint8_t, PAYLOAD_MAX_SIZE + 1> formatted_payload{};
+uint32_t formatted_payload_size{0u};
+uint32_t payload_error_handler_calls{0u};
+
+void capturing_formatter(const uint8_t *payload, uint32_t payload_size)
+{
+    std::memcpy(formatted_payload.data(), payload, payload_size);
+    formatted_payload_size = payload_size;
+}
+
+void counting_error_handler(void)
+{
+    payload_error_handler_calls++;
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(PayloadLogTest)
+{
+    void setup() override
+    {
+        init_runtime_diagnostics();
+        formatted_payload.fill(0u);
+        formatted_payload_size = 0u;
+        payload_error_handler_calls = 0u;
+    }
+
+    void teardown() override
+    {
+        deinit_runtime_diagnostics();
+        remove(PAYLOAD_TEST_OUTPUT_FILE);
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(PayloadLogTest, PayloadLogInitialSizeIsZero)
+{
+    LONGS_EQUAL(0u, get_payload_log_current_size());
+}
+
+TEST(PayloadLogTest, PayloadEntriesAreCounted)
+{
+    const uint32_t expected_and_actual[]{5u, 7u};
+    RUNTIME_TELEMETRY_PAYLOAD(0, "some_file.c: telemetry msg", expected_and_actual,
+                              sizeof(expected_and_actual));
+    RUNTIME_ERROR_PAYLOAD(1, "some_file.c: error msg", expected_and_actual,
+                          sizeof(expected_and_actual));
+
+    LONGS_EQUAL(2u, get_payload_log_current_size());
+}
+
+TEST(PayloadLogTest, PayloadIsPassedToFormatter)
+{
+    const uint64_t address{0x0123456789ABCDEFull};
+    set_payload_formatter(capturing_formatter);
+    RUNTIME_WARNING_PAYLOAD(0, "some_file.c: warning msg", &address, sizeof(address));
+
+    printf_to_output_file(PAYLOAD_TEST_OUTPUT_FILE, printf_payload_log);
+
+    LONGS_EQUAL(sizeof(address), formatted_payload_size);
+    CHECK(std::memcmp(&address, formatted_payload.data(), sizeof(address)) == 0);
+}
+
+TEST(PayloadLogTest, OversizedPayloadIsTruncated)
+{
+    std::array<uint8_t, PAYLOAD_MAX_SIZE + 1> payload{};
+    set_payload_formatter(capturing_formatter);
+    RUNTIME_ERROR_PAYLOAD(0, "some_file.c: error msg", payload.data(), payload.size());
+
+    printf_to_output_file(PAYLOAD_TEST_OUTPUT_FILE, printf_payload_log);
+
+    LONGS_EQUAL(PAYLOAD_MAX_SIZE, formatted_payload_size);
+    LONGS_EQUAL(PAYLOAD_MAX_SIZE, get_error_log_entry(0u).fail_value);
+}
+
+TEST(PayloadLogTest, PayloadLogIsPrintedAsHexByDefault)
+{
+    const uint8_t first_payload[]{0x01, 0xAB};
+    const uint8_t second_payload[]{0xFF};
+    RUNTIME_TELEMETRY_PAYLOAD(3, "some_file.c: telemetry msg", first_payload,
+                              sizeof(first_payload));
+    RUNTIME_ERROR_PAYLOAD(4, "some_file.c: error msg", second_payload, sizeof(second_payload));
+
+    printf_to_output_file(PAYLOAD_TEST_OUTPUT_FILE, printf_payload_log);
+
+    check_output_file_contents(PAYLOAD_TEST_OUTPUT_FILE,
+                               "telemetry 3 some_file.c: telemetry msg 01 AB\r\n"
+                               "error 4 some_file.c: error msg FF\r\n");
+}
+
+TEST(PayloadLogTest, OldestPayloadEntriesAreOverwritten)
+{
+    const uint8_t payload[PAYLOAD_MAX_SIZE]{};
+    for (uint32_t i{0u}; i < PAYLOAD_LOG_CAPACITY_BYTES; i++) {
+        RUNTIME_TELEMETRY_PAYLOAD(i, "some_file.c: telemetry msg", payload, sizeof(payload));
+    }
+
+    CHECK(get_payload_log_current_size() > 0u);
+    CHECK(get_payload_log_current_size() < PAYLOAD_LOG_CAPACITY_BYTES / PAYLOAD_MAX_SIZE);
+}
+
+TEST(PayloadLogTest, PayloadCallsAreCountedPerCategory)
+{
+    const uint8_t payload[]{0x01, 0x02, 0x03};
+    RUNTIME_TELEMETRY_PAYLOAD(0, "some_file.c: telemetry msg", payload, sizeof(payload));
+    RUNTIME_WARNING_PAYLOAD(1, "some_file.c: warning msg", payload, sizeof(payload));
+    RUNTIME_WARNING_PAYLOAD(2, "some_file.c: warning msg", payload, sizeof(payload));
+
+    LONGS_EQUAL(1u, get_telemetry_call_count());
+    LONGS_EQUAL(2u, get_warning_call_count());
+    LONGS_EQUAL(2u, get_warning_log_current_size());
+    LONGS_EQUAL(sizeof(payload), get_warning_log_entry(1u).fail_value);
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+    struct running_statistics stats{};
+    get_warning_statistics(&stats);
+    LONGS_EQUAL(2u, stats.event_count);
+#endif
+}
+
+TEST(PayloadLogTest, PayloadErrorCallsErrorHandler)
+{
+    const uint32_t expected_and_actual[]{5u, 7u};
+    set_error_handler(counting_error_handler);
+    RUNTIME_ERROR_PAYLOAD(1, "some_file.c: error msg", expected_and_actual,
+                          sizeof(expected_and_actual));
+
+    LONGS_EQUAL(1u, payload_error_handler_calls);
+    LONGS_EQUAL(1u, get_error_call_count());
+}
+
+TEST(PayloadLogTest, PayloadErrorIsRecordedAsFirstError)
+{
+    const uint32_t expected_and_actual[]{5u, 7u};
+    RUNTIME_ERROR_PAYLOAD(1, "some_file.c: first error msg", expected_and_actual,
+                          sizeof(expected_and_actual));
+    RUNTIME_ERROR(2, "some_file.c: second error msg", 3);
+
+    printf_to_output_file(PAYLOAD_TEST_OUTPUT_FILE, printf_first_runtime_error_entry);
+
+    check_output_file_contents(PAYLOAD_TEST_OUTPUT_FILE, "1 some_file.c: first error msg 8\r\n");
+}
@@ -0,0 +1,151 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_running_statistics.cpp                           */
+/*                                                                            */
+/* Test implementation for running_statistics.c                               */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "running_statistics.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+constexpr double FLOAT_TOLERANCE{0.001};
+
+struct running_statistics test_stats{};
+
+void update_with_values(const uint32_t *values, uint32_t count)
+{
+    for (uint32_t i{0u}; i < count; i++) {
+        update_running_statistics(&test_stats, 0u, values[i]);
+    }
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(RunningStatisticsTest)
+{
+    void setup() override
+    {
+        reset_running_statistics(&test_stats);
+    }
+
+    void teardown() override
+    {
+        reset_running_statistics(&test_stats);
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(RunningStatisticsTest, ResetStatisticsAreZero)
+{
+    LONGS_EQUAL(0u, test_stats.event_count);
+    LONGS_EQUAL(0u, test_stats.min_fail_value);
+    LONGS_EQUAL(0u, test_stats.max_fail_value);
+    DOUBLES_EQUAL(0.0, get_running_statistics_variance(&test_stats), FLOAT_TOLERANCE);
+}
+
+TEST(RunningStatisticsTest, MinMaxAreTracked)
+{
+    const uint32_t values[]{7u, 3u, 11u, 5u};
+    update_with_values(values, 4u);
+
+    LONGS_EQUAL(4u, test_stats.event_count);
+    LONGS_EQUAL(3u, test_stats.min_fail_value);
+    LONGS_EQUAL(11u, test_stats.max_fail_value);
+}
+
+TEST(RunningStatisticsTest, FirstValueIsBothMinAndMax)
+{
+    update_running_statistics(&test_stats, 0u, 42u);
+
+    LONGS_EQUAL(42u, test_stats.min_fail_value);
+    LONGS_EQUAL(42u, test_stats.max_fail_value);
+}
+
+TEST(RunningStatisticsTest, MeanAndVarianceMatchPopulationStatistics)
+{
+    // population mean 5, population variance 4
+    const uint32_t values[]{2u, 4u, 4u, 4u, 5u, 5u, 7u, 9u};
+    update_with_values(values, 8u);
+
+    DOUBLES_EQUAL(5.0, test_stats.mean_fail_value, FLOAT_TOLERANCE);
+    DOUBLES_EQUAL(4.0, get_running_statistics_variance(&test_stats), FLOAT_TOLERANCE);
+}
+
+TEST(RunningStatisticsTest, LargeValuesKeepTheirMeanAndVariance)
+{
+    // e.g. addresses or timestamps- beyond a float's 24 bit mantissa
+    constexpr uint32_t LARGE_VALUES_COUNT{100000u};
+    for (uint32_t i{0u}; i < LARGE_VALUES_COUNT; i++) {
+        update_running_statistics(&test_stats, 0u, 3000000000u + (i % 21u));
+    }
+
+    // 0..20 repeated- mean 10, variance (21^2 - 1) / 12 (give or take the partial cycle)
+    DOUBLES_EQUAL(3000000010.0, test_stats.mean_fail_value, 0.01);
+    DOUBLES_EQUAL(36.67, get_running_statistics_variance(&test_stats), 0.01);
+}
+
+TEST(RunningStatisticsTest, EventsInCurrentWindowAreCounted)
+{
+    update_running_statistics(&test_stats, 100u, 0u);
+    update_running_statistics(&test_stats, 200u, 0u);
+    update_running_statistics(&test_stats, 100u + RUNNING_STATISTICS_WINDOW_LENGTH - 1u, 0u);
+
+    LONGS_EQUAL(3u, test_stats.current_window_event_count);
+    LONGS_EQUAL(0u, test_stats.last_window_event_count);
+}
+
+TEST(RunningStatisticsTest, WindowRolloverKeepsLastWindowCount)
+{
+    update_running_statistics(&test_stats, 0u, 0u);
+    update_running_statistics(&test_stats, 1u, 0u);
+    update_running_statistics(&test_stats, RUNNING_STATISTICS_WINDOW_LENGTH, 0u);
+
+    LONGS_EQUAL(2u, test_stats.last_window_event_count);
+    LONGS_EQUAL(1u, test_stats.current_window_event_count);
+}
+
+TEST(RunningStatisticsTest, SkippedWindowsClearLastWindowCount)
+{
+    update_running_statistics(&test_stats, 0u, 0u);
+    update_running_statistics(&test_stats, 3u * RUNNING_STATISTICS_WINDOW_LENGTH, 0u);
+
+    LONGS_EQUAL(0u, test_stats.last_window_event_count);
+    LONGS_EQUAL(1u, test_stats.current_window_event_count);
+    LONGS_EQUAL(3u * RUNNING_STATISTICS_WINDOW_LENGTH, test_stats.window_start);
+}
+
+TEST(RunningStatisticsTest, WindowSurvivesTimestampWraparound)
+{
+    update_running_statistics(&test_stats, UINT32_MAX - 10u, 0u);
+    update_running_statistics(&test_stats, 5u, 0u);
+
+    LONGS_EQUAL(2u, test_stats.current_window_event_count);
+}
+
+TEST(RunningStatisticsTest, LateTimestampIsCountedInCurrentWindow)
+{
+    for (uint32_t i{0u}; i < 5u; i++) {
+        update_running_statistics(&test_stats, 5000u + i, 0u);
+    }
+    update_running_statistics(&test_stats, 4990u, 0u);
+
+    LONGS_EQUAL(6u, test_stats.current_window_event_count);
+    LONGS_EQUAL(5000u, test_stats.window_start);
+}
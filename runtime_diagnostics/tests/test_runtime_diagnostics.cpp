@@ -499,3 +499,461 @@ TEST(RuntimeDiagnosticsTest, DeinitResetsAllLogSizesToZero)
     LONGS_EQUAL(0u, get_warning_log_current_size());
     LONGS_EQUAL(0u, get_error_log_current_size());
 }
+
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+TEST(RuntimeDiagnosticsTest, StatisticsAreKeptPerCategory)
+{
+    RUNTIME_TELEMETRY(0, "some_file.c: telemetry message", 4);
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry message", 8);
+    RUNTIME_WARNING(2, "some_file.c: warning message", 3);
+
+    struct running_statistics stats{};
+    get_telemetry_statistics(&stats);
+    LONGS_EQUAL(2u, stats.event_count);
+    LONGS_EQUAL(4u, stats.min_fail_value);
+    LONGS_EQUAL(8u, stats.max_fail_value);
+
+    get_warning_statistics(&stats);
+    LONGS_EQUAL(1u, stats.event_count);
+
+    get_error_statistics(&stats);
+    LONGS_EQUAL(0u, stats.event_count);
+}
+
+TEST(RuntimeDiagnosticsTest, StatisticsAreKeptPerCallSite)
+{
+    const char *first_call_site{"some_file.c: first msg"};
+    const char *second_call_site{"some_file.c: second msg"};
+
+    RUNTIME_WARNING(0, first_call_site, 1);
+    RUNTIME_WARNING(0, first_call_site, 3);
+    RUNTIME_ERROR(0, second_call_site, 9);
+
+    struct running_statistics stats{};
+    CHECK(get_call_site_statistics(first_call_site, &stats));
+    LONGS_EQUAL(2u, stats.event_count);
+    LONGS_EQUAL(3u, stats.max_fail_value);
+
+    CHECK(get_call_site_statistics(second_call_site, &stats));
+    LONGS_EQUAL(1u, stats.event_count);
+
+    CHECK_FALSE(get_call_site_statistics("some_file.c: never logged", &stats));
+}
+
+TEST(RuntimeDiagnosticsTest, CallSitesBeyondCapacityAreCountedAsUntracked)
+{
+    static char call_sites[CALL_SITE_STATISTICS_CAPACITY + 3][8]{};
+    for (auto &call_site : call_sites) {
+        RUNTIME_TELEMETRY(0, call_site, 0);
+    }
+
+    LONGS_EQUAL(3u, get_untracked_call_site_event_count());
+}
+
+TEST(RuntimeDiagnosticsTest, StatisticsAreClearedOnInit)
+{
+    RUNTIME_ERROR(0, "some_file.c: error message", 5);
+    init_runtime_diagnostics();
+
+    struct running_statistics stats{};
+    get_error_statistics(&stats);
+    LONGS_EQUAL(0u, stats.event_count);
+    CHECK_FALSE(get_call_site_statistics("some_file.c: error message", &stats));
+}
+
+TEST(RuntimeDiagnosticsTest, StatisticsArePrinted)
+{
+    const char *call_site{"some_file.c: error message"};
+    RUNTIME_ERROR(0, call_site, 2);
+    RUNTIME_ERROR(1, call_site, 4);
+
+    FILE *file{fopen(TEST_EXPECTATIONS_FILE, "w")};
+    CHECK(file != nullptr);
+
+    CHECK(fprintf(file, "telemetry: count 0, last window 0, current window 0, min 0, max 0, "
+                        "mean 0.00, variance 0.00\r\n")
+          > 0);
+    CHECK(fprintf(file, "warning: count 0, last window 0, current window 0, min 0, max 0, "
+                        "mean 0.00, variance 0.00\r\n")
+          > 0);
+    CHECK(fprintf(file, "error: count 2, last window 0, current window 2, min 2, max 4, "
+                        "mean 3.00, variance 1.00\r\n")
+          > 0);
+    CHECK(fprintf(file, "some_file.c: error message: count 2, last window 0, current window 2, "
+                        "min 2, max 4, mean 3.00, variance 1.00\r\n")
+          > 0);
+    CHECK(fprintf(file, "untracked call sites: 0\r\n") > 0);
+
+    fclose(file);
+
+    printf_statistics();
+    fflush(stdout);
+
+    CHECK(test_output_and_expectation_are_identical());
+}
+#endif
+
+TEST(RuntimeDiagnosticsTest, DeferredErrorHandlerIsCalledOnPoll)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    set_error_handler(dummy_callback_function);
+    RUNTIME_ERROR(1, "some_file.c: error message", 2);
+    CHECK_FALSE(dummy_error_callback_called);
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    CHECK(dummy_error_callback_called);
+}
+
+TEST(RuntimeDiagnosticsTest, DeferredWarningHandlerIsCalledOnPoll)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    set_warning_handler(dummy_callback_function);
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY; i++) {
+        RUNTIME_WARNING(i, "some_file.c: warning msg", i + 1);
+    }
+    CHECK_FALSE(dummy_error_callback_called);
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    CHECK(dummy_error_callback_called);
+}
+
+TEST(RuntimeDiagnosticsTest, LogEntriesAreReturnedOldestFirst)
+{
+    // overflowing by arbitrary prime number
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY + 107u; i++) {
+        RUNTIME_WARNING(i, "some_file.c: warning msg", i + 1);
+    }
+
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY; i++) {
+        const struct log_entry entry{get_warning_log_entry(i)};
+        LONGS_EQUAL(107u + i, entry.timestamp);
+        LONGS_EQUAL(108u + i, entry.fail_value);
+    }
+}
+
+TEST(RuntimeDiagnosticsTest, OutOfRangeLogEntryIsEmpty)
+{
+    RUNTIME_TELEMETRY(5, "some_file.c: telemetry msg", 6);
+
+    const struct log_entry entry{get_telemetry_log_entry(1u)};
+    LONGS_EQUAL(0u, entry.timestamp);
+    POINTERS_EQUAL(nullptr, entry.fail_message);
+    LONGS_EQUAL(0u, entry.fail_value);
+}
+
+TEST(RuntimeDiagnosticsTest, CallCountsAreReturnedPerCategory)
+{
+    RUNTIME_ERROR(0, "some_file.c: error message", 0);
+    RUNTIME_WARNING(0, "some_file.c: warning message", 0);
+    RUNTIME_WARNING(0, "some_file.c: warning message", 0);
+
+    LONGS_EQUAL(0u, get_telemetry_call_count());
+    LONGS_EQUAL(2u, get_warning_call_count());
+    LONGS_EQUAL(1u, get_error_call_count());
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+TEST(RuntimeDiagnosticsTest, CaptureIsNotTriggeredWithoutError)
+{
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    RUNTIME_WARNING(3, "some_file.c: warning msg", 4);
+
+    CHECK_FALSE(is_capture_triggered());
+    LONGS_EQUAL(0u, get_captured_telemetry_log_size());
+    LONGS_EQUAL(0u, get_post_trigger_capture_size());
+}
+
+TEST(RuntimeDiagnosticsTest, FirstErrorFreezesAllLogs)
+{
+    // overflowing by arbitrary prime number
+    for (uint32_t i{0u}; i < TELEMETRY_LOG_CAPACITY + 107u; i++) {
+        RUNTIME_TELEMETRY(i, "some_file.c: telemetry msg", i + 1);
+    }
+    RUNTIME_WARNING(1000, "some_file.c: warning msg", 1001);
+    RUNTIME_ERROR(2000, "some_file.c: error msg", 2001);
+    for (uint32_t i{0u}; i < TELEMETRY_LOG_CAPACITY; i++) {
+        RUNTIME_TELEMETRY(3000 + i, "some_file.c: telemetry msg", 0);
+    }
+
+    CHECK(is_capture_triggered());
+    LONGS_EQUAL(ERROR_LOG, get_capture_trigger_entry().log);
+    LONGS_EQUAL(2000u, get_capture_trigger_entry().entry.timestamp);
+
+    LONGS_EQUAL(TELEMETRY_LOG_CAPACITY, get_captured_telemetry_log_size());
+    for (uint32_t i{0u}; i < TELEMETRY_LOG_CAPACITY; i++) {
+        LONGS_EQUAL(107u + i, get_captured_telemetry_log_entry(i).timestamp);
+    }
+    LONGS_EQUAL(1u, get_captured_warning_log_size());
+    LONGS_EQUAL(1000u, get_captured_warning_log_entry(0u).timestamp);
+    LONGS_EQUAL(1u, get_captured_error_log_size());
+    LONGS_EQUAL(2001u, get_captured_error_log_entry(0u).fail_value);
+    POINTERS_EQUAL(nullptr, get_captured_error_log_entry(1u).fail_message);
+}
+
+TEST(RuntimeDiagnosticsTest, PostTriggerEntriesAreRecordedUntilFull)
+{
+    RUNTIME_ERROR(0, "some_file.c: error msg", 0);
+    RUNTIME_WARNING(1, "some_file.c: warning msg", 2);
+    CHECK_FALSE(is_capture_complete());
+
+    for (uint32_t i{0u}; i < POST_TRIGGER_CAPTURE_CAPACITY; i++) {
+        RUNTIME_TELEMETRY(i + 3, "some_file.c: telemetry msg", 0);
+    }
+
+    CHECK(is_capture_complete());
+    LONGS_EQUAL(POST_TRIGGER_CAPTURE_CAPACITY, get_post_trigger_capture_size());
+    LONGS_EQUAL(WARNING_LOG, get_post_trigger_capture_entry(0u).log);
+    LONGS_EQUAL(2u, get_post_trigger_capture_entry(0u).entry.fail_value);
+    LONGS_EQUAL(TELEMETRY_LOG, get_post_trigger_capture_entry(1u).log);
+    LONGS_EQUAL(POST_TRIGGER_CAPTURE_CAPACITY + 1u,
+                get_post_trigger_capture_entry(POST_TRIGGER_CAPTURE_CAPACITY - 1u).entry.timestamp);
+}
+
+bool warning_above_limit(enum runtime_log log, struct log_entry entry)
+{
+    return (log == WARNING_LOG) && (entry.fail_value > 100u);
+}
+
+TEST(RuntimeDiagnosticsTest, CaptureTriggerCanBeSet)
+{
+    set_capture_trigger(warning_above_limit);
+    RUNTIME_ERROR(0, "some_file.c: error msg", 0);
+    RUNTIME_WARNING(1, "some_file.c: warning msg", 100);
+    CHECK_FALSE(is_capture_triggered());
+
+    RUNTIME_WARNING(2, "some_file.c: warning msg", 101);
+    CHECK(is_capture_triggered());
+    LONGS_EQUAL(WARNING_LOG, get_capture_trigger_entry().log);
+    LONGS_EQUAL(2u, get_captured_warning_log_size());
+    LONGS_EQUAL(1u, get_captured_error_log_size());
+}
+
+TEST(RuntimeDiagnosticsTest, RearmedCaptureTriggersAgain)
+{
+    RUNTIME_ERROR(0, "some_file.c: error msg", 0);
+    rearm_capture();
+    CHECK_FALSE(is_capture_triggered());
+    LONGS_EQUAL(0u, get_captured_error_log_size());
+
+    RUNTIME_ERROR(1, "some_file.c: error msg", 0);
+    LONGS_EQUAL(1u, get_capture_trigger_entry().entry.timestamp);
+    LONGS_EQUAL(2u, get_captured_error_log_size());
+}
+
+TEST(RuntimeDiagnosticsTest, CaptureIsClearedOnInit)
+{
+    set_capture_trigger(warning_above_limit);
+    RUNTIME_WARNING(1, "some_file.c: warning msg", 101);
+    init_runtime_diagnostics();
+
+    CHECK_FALSE(is_capture_triggered());
+    RUNTIME_ERROR(2, "some_file.c: error msg", 0);
+    CHECK(is_capture_triggered());
+}
+
+TEST(RuntimeDiagnosticsTest, CaptureIsPrinted)
+{
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    RUNTIME_ERROR(3, "some_file.c: error msg", 4);
+    RUNTIME_WARNING(5, "some_file.c: warning msg", 6);
+
+    FILE *file{fopen(TEST_EXPECTATIONS_FILE, "w")};
+    CHECK(file != nullptr);
+
+    CHECK(fprintf(file, "trigger: error 3 some_file.c: error msg 4\r\n") > 0);
+    CHECK(fprintf(file, "telemetry:\r\n1 some_file.c: telemetry msg 2\r\n") > 0);
+    CHECK(fprintf(file, "warning:\r\n") > 0);
+    CHECK(fprintf(file, "error:\r\n3 some_file.c: error msg 4\r\n") > 0);
+    CHECK(fprintf(file, "post-trigger:\r\nwarning 5 some_file.c: warning msg 6\r\n") > 0);
+
+    fclose(file);
+
+    printf_capture();
+    fflush(stdout);
+
+    CHECK(test_output_and_expectation_are_identical());
+}
+#endif
+
+TEST(RuntimeDiagnosticsTest, AllSubsystemsAreEnabledByDefault)
+{
+    LONGS_EQUAL(ALL_SUBSYSTEMS_ENABLED, get_subsystem_enable_mask());
+    RUNTIME_TELEMETRY_TAGGED(0, 1, "some_file.c: telemetry msg", 2);
+    RUNTIME_WARNING_TAGGED(RUNTIME_SUBSYSTEMS_COUNT - 1u, 3, "some_file.c: warning msg", 4);
+    RUNTIME_ERROR_TAGGED(7, 5, "some_file.c: error msg", 6);
+
+    LONGS_EQUAL(1u, get_telemetry_log_current_size());
+    LONGS_EQUAL(1u, get_warning_log_current_size());
+    LONGS_EQUAL(1u, get_error_log_current_size());
+    LONGS_EQUAL(6u, get_error_log_entry(0u).fail_value);
+}
+
+TEST(RuntimeDiagnosticsTest, DisabledSubsystemIsDropped)
+{
+    disable_subsystem(3);
+    RUNTIME_TELEMETRY_TAGGED(3, 1, "some_file.c: telemetry msg", 2);
+    RUNTIME_TELEMETRY_TAGGED(4, 3, "some_file.c: telemetry msg", 4);
+
+    LONGS_EQUAL(1u, get_telemetry_log_current_size());
+    LONGS_EQUAL(1u, get_telemetry_call_count());
+    LONGS_EQUAL(3u, get_telemetry_log_entry(0u).timestamp);
+}
+
+TEST(RuntimeDiagnosticsTest, DisabledErrorSubsystemSkipsHandler)
+{
+    set_error_handler(dummy_callback_function);
+    set_subsystem_enable_mask(0u);
+    RUNTIME_ERROR_TAGGED(1, 1, "some_file.c: error msg", 2);
+
+    CHECK_FALSE(dummy_error_callback_called);
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+    CHECK_FALSE(is_capture_triggered());
+#endif
+    LONGS_EQUAL(0u, get_error_call_count());
+}
+
+TEST(RuntimeDiagnosticsTest, SubsystemCanBeEnabledAgain)
+{
+    set_subsystem_enable_mask(0u);
+    enable_subsystem(5);
+    LONGS_EQUAL(1u << 5, get_subsystem_enable_mask());
+
+    RUNTIME_WARNING_TAGGED(5, 1, "some_file.c: warning msg", 2);
+    RUNTIME_WARNING_TAGGED(6, 3, "some_file.c: warning msg", 4);
+    LONGS_EQUAL(1u, get_warning_log_current_size());
+}
+
+TEST(RuntimeDiagnosticsTest, UntaggedCallsIgnoreSubsystemMask)
+{
+    set_subsystem_enable_mask(0u);
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(1u, get_telemetry_log_current_size());
+}
+
+TEST(RuntimeDiagnosticsTest, OutOfRangeSubsystemIsDropped)
+{
+    RUNTIME_TELEMETRY_TAGGED(RUNTIME_SUBSYSTEMS_COUNT, 1, "some_file.c: telemetry msg", 2);
+    LONGS_EQUAL(0u, get_telemetry_log_current_size());
+}
+
+TEST(RuntimeDiagnosticsTest, OutOfRangeSubsystemDoesNotAliasAnother)
+{
+    disable_subsystem(RUNTIME_SUBSYSTEMS_COUNT);
+    LONGS_EQUAL(ALL_SUBSYSTEMS_ENABLED, get_subsystem_enable_mask());
+
+    set_subsystem_enable_mask(0u);
+    enable_subsystem(RUNTIME_SUBSYSTEMS_COUNT);
+    LONGS_EQUAL(0u, get_subsystem_enable_mask());
+}
+
+TEST(RuntimeDiagnosticsTest, SubsystemMaskIsResetOnInit)
+{
+    set_subsystem_enable_mask(0u);
+    init_runtime_diagnostics();
+    LONGS_EQUAL(ALL_SUBSYSTEMS_ENABLED, get_subsystem_enable_mask());
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+#if defined(_MSC_VER)
+#define TEST_NOINLINE __declspec(noinline)
+#else
+#define TEST_NOINLINE __attribute__((noinline))
+#endif
+
+// tail calls, as here, rely on the -fno-optimize-sibling-calls the option adds
+TEST_NOINLINE void log_warning_from_first_call_site(uint32_t timestamp)
+{
+    RUNTIME_WARNING(timestamp, "some_file.c: warning msg", 0);
+}
+
+TEST_NOINLINE void log_warning_from_second_call_site(uint32_t timestamp)
+{
+    RUNTIME_WARNING(timestamp, "some_file.c: warning msg", 1);
+}
+
+TEST(RuntimeDiagnosticsTest, CallSitesAreRecordedPerEntry)
+{
+    log_warning_from_first_call_site(0);
+    log_warning_from_first_call_site(1);
+    log_warning_from_second_call_site(2);
+
+    CHECK(get_warning_call_site(0u) != 0u);
+    CHECK(get_warning_call_site(0u) == get_warning_call_site(1u));
+    CHECK(get_warning_call_site(1u) != get_warning_call_site(2u));
+    LONGS_EQUAL(0u, get_warning_call_site(3u));
+    LONGS_EQUAL(0u, get_telemetry_call_site(0u));
+}
+
+TEST(RuntimeDiagnosticsTest, CallSitesFollowOverwrittenEntries)
+{
+    // overflowing by arbitrary prime number
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY + 107u; i++) {
+        if (i % 2u == 0u) {
+            log_warning_from_first_call_site(i);
+        } else {
+            log_warning_from_second_call_site(i);
+        }
+    }
+
+    const uintptr_t odd_call_site{get_warning_call_site(0u)};
+    const uintptr_t even_call_site{get_warning_call_site(1u)};
+    CHECK(odd_call_site != even_call_site);
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY; i++) {
+        const bool odd_timestamp{(get_warning_log_entry(i).timestamp % 2u) == 1u};
+        CHECK(get_warning_call_site(i) == (odd_timestamp ? odd_call_site : even_call_site));
+    }
+}
+
+TEST(RuntimeDiagnosticsTest, CallSitesAreReplacedAfterInit)
+{
+    log_warning_from_first_call_site(0);
+    const uintptr_t first_call_site{get_warning_call_site(0u)};
+    init_runtime_diagnostics();
+    log_warning_from_second_call_site(1);
+
+    // the entry reusing slot 0 must report its own call site, not the stale one
+    CHECK(get_warning_call_site(0u) != 0u);
+    CHECK(get_warning_call_site(0u) != first_call_site);
+}
+
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+TEST(RuntimeDiagnosticsTest, CallSitesAreFrozenWithTheCapture)
+{
+    log_warning_from_first_call_site(0);
+    const uintptr_t first_call_site{get_warning_call_site(0u)};
+    RUNTIME_ERROR(1, "some_file.c: error msg", 0);
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY; i++) {
+        log_warning_from_second_call_site(2u + i);
+    }
+
+    CHECK(get_warning_call_site(0u) != first_call_site);
+    CHECK(get_captured_warning_call_site(0u) == first_call_site);
+    CHECK(get_captured_error_call_site(0u) != 0u);
+    LONGS_EQUAL(0u, get_captured_warning_call_site(1u));
+    LONGS_EQUAL(0u, get_captured_telemetry_call_site(0u));
+}
+#endif
+
+TEST(RuntimeDiagnosticsTest, CallSitesArePrinted)
+{
+    log_warning_from_first_call_site(5);
+    RUNTIME_ERROR(7, "some_file.c: error msg", 8);
+
+    FILE *file{fopen(TEST_EXPECTATIONS_FILE, "w")};
+    CHECK(file != nullptr);
+
+    CHECK(fprintf(file, "warning 0x%" PRIxPTR " 5 some_file.c: warning msg 0\r\n",
+                  get_warning_call_site(0u))
+          > 0);
+    CHECK(fprintf(file, "error 0x%" PRIxPTR " 7 some_file.c: error msg 8\r\n",
+                  get_error_call_site(0u))
+          > 0);
+
+    fclose(file);
+
+    printf_call_sites();
+    fflush(stdout);
+
+    CHECK(test_output_and_expectation_are_identical());
+}
+#endif
@@ -0,0 +1,172 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_runtime_log.cpp                                  */
+/*                                                                            */
+/* Test implementation for runtime_log.hpp                                    */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+#include "runtime_log.hpp"
+
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+#include <cstring>
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+using runtime_diagnostics::ErrorLog;
+using runtime_diagnostics::TelemetryLog;
+using runtime_diagnostics::WarningLog;
+
+uint32_t warning_log_full_calls{0u};
+uint32_t runtime_error_calls{0u};
+
+struct CountingHandlerPolicy
+{
+    static void on_warning_log_full()
+    {
+        warning_log_full_calls++;
+    }
+
+    static void on_runtime_error()
+    {
+        runtime_error_calls++;
+    }
+};
+
+template <typename Log>
+void add_n_entries(Log &log, uint32_t n)
+{
+    for (uint32_t i{0u}; i < n; i++) {
+        log.add(i, "some_file.cpp: some msg", i + 1);
+    }
+}
+
+template <typename Log>
+void check_log_holds_last_capacity_entries(const Log &log, uint32_t total_entries)
+{
+    const uint32_t first_kept{total_entries - Log::CAPACITY};
+
+    LONGS_EQUAL(Log::CAPACITY, log.get_current_size());
+    for (uint32_t i{0u}; i < Log::CAPACITY; i++) {
+        const log_entry entry{log.get_entry_at_index(i)};
+        LONGS_EQUAL(first_kept + i, entry.timestamp);
+        LONGS_EQUAL(first_kept + i + 1, entry.fail_value);
+    }
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(RuntimeLogTest)
+{
+    void setup() override
+    {
+        warning_log_full_calls = 0u;
+        runtime_error_calls = 0u;
+    }
+
+    void teardown() override
+    {
+        warning_log_full_calls = 0u;
+        runtime_error_calls = 0u;
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(RuntimeLogTest, LogInitialSizeIsZero)
+{
+    TelemetryLog<32> log;
+    LONGS_EQUAL(0u, log.get_current_size());
+    LONGS_EQUAL(0u, log.get_call_count());
+}
+
+TEST(RuntimeLogTest, CapacityIsPowerOfTwoIsDetected)
+{
+    CHECK(TelemetryLog<32>::CAPACITY_IS_POWER_OF_TWO);
+    CHECK(TelemetryLog<1>::CAPACITY_IS_POWER_OF_TWO);
+    CHECK_FALSE(TelemetryLog<12>::CAPACITY_IS_POWER_OF_TWO);
+}
+
+TEST(RuntimeLogTest, EntriesAreReturnedOldestFirst)
+{
+    TelemetryLog<32> log;
+    add_n_entries(log, 5u);
+
+    LONGS_EQUAL(5u, log.get_current_size());
+    for (uint32_t i{0u}; i < 5u; i++) {
+        const log_entry entry{log.get_entry_at_index(i)};
+        LONGS_EQUAL(i, entry.timestamp);
+        STRCMP_EQUAL("some_file.cpp: some msg", entry.fail_message);
+        LONGS_EQUAL(i + 1, entry.fail_value);
+    }
+}
+
+TEST(RuntimeLogTest, OverflowEntriesToPowerOfTwoLog)
+{
+    // overflowing by arbitrary prime number
+    TelemetryLog<16> log;
+    add_n_entries(log, 16u + 107u);
+    check_log_holds_last_capacity_entries(log, 16u + 107u);
+    LONGS_EQUAL(16u + 107u, log.get_call_count());
+}
+
+TEST(RuntimeLogTest, OverflowEntriesToNonPowerOfTwoLog)
+{
+    // overflowing by arbitrary prime number
+    TelemetryLog<12> log;
+    add_n_entries(log, 12u + 107u);
+    check_log_holds_last_capacity_entries(log, 12u + 107u);
+}
+
+TEST(RuntimeLogTest, FullWarningLogCallsPolicyHandler)
+{
+    WarningLog<8, CountingHandlerPolicy> log;
+    add_n_entries(log, 7u);
+    LONGS_EQUAL(0u, warning_log_full_calls);
+    add_n_entries(log, 1u);
+    LONGS_EQUAL(1u, warning_log_full_calls);
+}
+
+TEST(RuntimeLogTest, TelemetryLogNeverCallsPolicyHandlers)
+{
+    TelemetryLog<8, CountingHandlerPolicy> log;
+    add_n_entries(log, 20u);
+    LONGS_EQUAL(0u, warning_log_full_calls);
+    LONGS_EQUAL(0u, runtime_error_calls);
+}
+
+TEST(RuntimeLogTest, ErrorLogCallsPolicyHandlerOnEveryError)
+{
+    ErrorLog<8, CountingHandlerPolicy> log;
+    add_n_entries(log, 3u);
+    LONGS_EQUAL(3u, runtime_error_calls);
+    CHECK(log.is_runtime_error_asserted());
+}
+
+TEST(RuntimeLogTest, FirstErrorIsSavedAfterOverflow)
+{
+    ErrorLog<8> log;
+    log.add(0, "some_file.cpp: error message", 0);
+    add_n_entries(log, 8u);
+
+    const log_entry first{log.get_first_runtime_error_cause()};
+    LONGS_EQUAL(0u, first.timestamp);
+    STRCMP_EQUAL("some_file.cpp: error message", first.fail_message);
+}
+
+TEST(RuntimeLogTest, ResetClearsLog)
+{
+    ErrorLog<8> log;
+    add_n_entries(log, 3u);
+    log.reset();
+
+    LONGS_EQUAL(0u, log.get_current_size());
+    LONGS_EQUAL(0u, log.get_call_count());
+    CHECK_FALSE(log.is_runtime_error_asserted());
+}
@@ -0,0 +1,210 @@
+/*================================ FILE INFO =================================*/
+/* Filename           : test_self_profiling.cpp                               */
+/*                                                                            */
+/* Test implementation for self_profiling.c (w/ self profiling enabled)       */
+/*                                                                            */
+/*============================================================================*/
+
+/*============================================================================*/
+/*                               Include Files                                */
+/*============================================================================*/
+extern "C"
+{
+
+#include <stdint.h>
+#include "payload_log.h"
+#include "runtime_diagnostics.h"
+#include "self_profiling_probes.h"
+
+}
+
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+#include <cstdio>
+#include "test_output_file.hpp"
+
+/*============================================================================*/
+/*                             Public Definitions                             */
+/*============================================================================*/
+constexpr const char *PROFILING_TEST_OUTPUT_FILE{"profiling_test_output.txt"};
+constexpr uint32_t SLOW_HANDLER_CYCLES{1000u};
+
+// every read advances the fake counter, so a sample w/ nothing in between is one step long
+uint32_t fake_cycles{0u};
+uint32_t fake_cycles_per_read{0u};
+
+uint32_t fake_cycle_counter(void)
+{
+    fake_cycles += fake_cycles_per_read;
+    return fake_cycles;
+}
+
+void slow_handler(void)
+{
+    fake_cycles += SLOW_HANDLER_CYCLES;
+}
+
+struct profiling_statistics get_probe_statistics(enum profiling_probe probe)
+{
+    struct profiling_statistics stats{};
+    get_profiling_statistics(probe, &stats);
+    return stats;
+}
+
+void add_sample_of(uint32_t cycles)
+{
+    const uint32_t start_cycles{start_profiling_sample()};
+    fake_cycles += cycles;
+    end_profiling_sample(TELEMETRY_PROFILING_PROBE, start_cycles);
+}
+
+/*============================================================================*/
+/*                                 Test Group                                 */
+/*============================================================================*/
+TEST_GROUP(SelfProfilingTest)
+{
+    void setup() override
+    {
+        init_runtime_diagnostics();
+        fake_cycles = 0u;
+        fake_cycles_per_read = 0u;
+        set_profiling_cycle_counter(fake_cycle_counter);
+    }
+
+    void teardown() override
+    {
+        deinit_runtime_diagnostics();
+        remove(PROFILING_TEST_OUTPUT_FILE);
+    }
+};
+
+/*============================================================================*/
+/*                                    Tests                                   */
+/*============================================================================*/
+TEST(SelfProfilingTest, NothingIsSampledWithoutCycleCounter)
+{
+    set_profiling_cycle_counter(nullptr);
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+
+    LONGS_EQUAL(0u, get_probe_statistics(TELEMETRY_PROFILING_PROBE).sample_count);
+}
+
+TEST(SelfProfilingTest, RuntimeCallsAreSampledPerCategory)
+{
+    fake_cycles_per_read = 10u;
+    RUNTIME_TELEMETRY(1, "some_file.c: telemetry msg", 2);
+    RUNTIME_TELEMETRY(3, "some_file.c: telemetry msg", 4);
+    RUNTIME_WARNING(5, "some_file.c: warning msg", 6);
+
+    const struct profiling_statistics telemetry_stats{
+            get_probe_statistics(TELEMETRY_PROFILING_PROBE)};
+    LONGS_EQUAL(2u, telemetry_stats.sample_count);
+    LONGS_EQUAL(20u, telemetry_stats.total_cycles);
+    LONGS_EQUAL(10u, telemetry_stats.max_cycles);
+    LONGS_EQUAL(2u, telemetry_stats.histogram[3]);
+    LONGS_EQUAL(1u, get_probe_statistics(WARNING_PROFILING_PROBE).sample_count);
+    LONGS_EQUAL(0u, get_probe_statistics(ERROR_PROFILING_PROBE).sample_count);
+}
+
+TEST(SelfProfilingTest, HandlerTimeIsSampledSeparately)
+{
+    fake_cycles_per_read = 1u;
+    set_error_handler(slow_handler);
+    RUNTIME_ERROR(1, "some_file.c: error msg", 2);
+
+    const struct profiling_statistics handler_stats{
+            get_probe_statistics(ERROR_HANDLER_PROFILING_PROBE)};
+    LONGS_EQUAL(1u, handler_stats.sample_count);
+    LONGS_EQUAL(SLOW_HANDLER_CYCLES + 1u, handler_stats.max_cycles);
+    LONGS_EQUAL(1u, handler_stats.histogram[9]);
+    LONGS_EQUAL(1u, get_probe_statistics(ERROR_PROFILING_PROBE).max_cycles);
+}
+
+TEST(SelfProfilingTest, DeferredHandlersAreSampledOnPoll)
+{
+    set_handler_dispatch_mode(HANDLER_DISPATCH_DEFERRED);
+    set_warning_handler(slow_handler);
+    for (uint32_t i{0u}; i < WARNING_LOG_CAPACITY; i++) {
+        RUNTIME_WARNING(i, "some_file.c: warning msg", i + 1);
+    }
+    LONGS_EQUAL(0u, get_probe_statistics(WARNING_HANDLER_PROFILING_PROBE).sample_count);
+
+    LONGS_EQUAL(1u, poll_deferred_handlers());
+    LONGS_EQUAL(SLOW_HANDLER_CYCLES,
+                get_probe_statistics(WARNING_HANDLER_PROFILING_PROBE).total_cycles);
+}
+
+TEST(SelfProfilingTest, EveryLogDumpIsSampled)
+{
+    void (*const log_dumps[])(void){printf_telemetry_log,
+                                    printf_warning_log,
+                                    printf_error_log,
+                                    printf_first_runtime_error_entry,
+                                    printf_call_counts,
+#if defined(RUNTIME_DIAGNOSTICS_STATISTICS)
+                                    printf_statistics,
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_WINDOW)
+                                    printf_capture,
+#endif
+#if defined(RUNTIME_DIAGNOSTICS_CAPTURE_CALL_SITES)
+                                    printf_call_sites,
+#endif
+                                    printf_payload_log};
+    for (void (*const log_dump)(void) : log_dumps) {
+        printf_to_output_file(PROFILING_TEST_OUTPUT_FILE, log_dump);
+    }
+
+    LONGS_EQUAL(sizeof(log_dumps) / sizeof(log_dumps[0]),
+                get_probe_statistics(LOG_DUMP_PROFILING_PROBE).sample_count);
+}
+
+TEST(SelfProfilingTest, HistogramBucketsArePowersOfTwo)
+{
+    const uint32_t samples[]{0u, 1u, 2u, 3u, 4u, 1023u, 1024u, UINT32_MAX};
+    for (const uint32_t cycles : samples) {
+        add_sample_of(cycles);
+    }
+
+    const struct profiling_statistics stats{get_probe_statistics(TELEMETRY_PROFILING_PROBE)};
+    LONGS_EQUAL(2u, stats.histogram[0]);
+    LONGS_EQUAL(2u, stats.histogram[1]);
+    LONGS_EQUAL(1u, stats.histogram[2]);
+    LONGS_EQUAL(1u, stats.histogram[9]);
+    LONGS_EQUAL(1u, stats.histogram[10]);
+    LONGS_EQUAL(1u, stats.histogram[31]);
+    CHECK(stats.total_cycles > UINT32_MAX);
+}
+
+TEST(SelfProfilingTest, SamplesSurviveCounterWraparound)
+{
+    fake_cycles = UINT32_MAX - 15u;
+    add_sample_of(32u);
+
+    LONGS_EQUAL(32u, get_probe_statistics(TELEMETRY_PROFILING_PROBE).max_cycles);
+}
+
+TEST(SelfProfilingTest, ProfilingIsClearedOnInit)
+{
+    add_sample_of(5u);
+    init_runtime_diagnostics();
+    add_sample_of(5u);
+
+    LONGS_EQUAL(0u, get_probe_statistics(TELEMETRY_PROFILING_PROBE).sample_count);
+}
+
+TEST(SelfProfilingTest, ReportIsPrinted)
+{
+    add_sample_of(5u);
+    add_sample_of(6u);
+    add_sample_of(0u);
+
+    printf_to_output_file(PROFILING_TEST_OUTPUT_FILE, printf_profiling_report);
+    check_output_file_contents(PROFILING_TEST_OUTPUT_FILE,
+                               "telemetry: samples 3, total 11, max 6, histogram [0+] 1 [4+] 2\r\n"
+                               "warning: samples 0, total 0, max 0, histogram\r\n"
+                               "error: samples 0, total 0, max 0, histogram\r\n"
+                               "warning handler: samples 0, total 0, max 0, histogram\r\n"
+                               "error handler: samples 0, total 0, max 0, histogram\r\n"
+                               "log dump: samples 0, total 0, max 0, histogram\r\n");
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#--------------------------------- FILE INFO ----------------------------------#
+# Filename           : symbolize_call_sites.py                                 #
+#                                                                              #
+# Resolves printf_call_sites() output against the ELF it came from (host only) #
+#                                                                              #
+#------------------------------------------------------------------------------#
+"""
+Reads printf_call_sites() lines ("<log> 0x<address> <entry>") from a file or
+stdin and appends "at <function> <file>:<line>" to each one, using addr2line.
+
+    python3 symbolize_call_sites.py firmware.elf dump.txt
+    python3 symbolize_call_sites.py --addr2line avr32-addr2line firmware.elf < dump.txt
+
+Position independent executables (the default on most linux toolchains) are
+loaded at a random base- pass it w/ --load-base (first line of
+/proc/<pid>/maps for the executable) or link the executable w/ -no-pie.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+CALL_SITE_PATTERN = re.compile(r"^(\w+) 0x([0-9a-fA-F]+) ")
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description="symbolize printf_call_sites() output")
+    parser.add_argument("elf", help="executable the dump came from, built w/ -g")
+    parser.add_argument("dump", nargs="?", help="printf_call_sites() output (default: stdin)")
+    parser.add_argument("--addr2line", default="addr2line", help="e.g. a cross toolchain's")
+    parser.add_argument("--load-base", default="0", help="runtime load address of a PIE, in hex")
+    return parser.parse_args()
+
+
+def symbolize(addr2line, elf, addresses):
+    """returns "<function> <file>:<line>" per address, in order"""
+    if not addresses:
+        return []
+
+    # return addresses point past the call- step back into the call instruction
+    result = subprocess.run([addr2line, "-e", elf, "-f", "-C"]
+                            + ["0x%x" % (address - 1) for address in addresses],
+                            capture_output=True, text=True, check=True)
+    output_lines = result.stdout.splitlines()
+    return ["%s %s" % (output_lines[i], output_lines[i + 1])
+            for i in range(0, len(output_lines), 2)]
+
+
+def main():
+    arguments = parse_arguments()
+    load_base = int(arguments.load_base, 16)
+
+    if arguments.dump is None:
+        dump_lines = sys.stdin.read().splitlines()
+    else:
+        with open(arguments.dump, encoding="utf-8", errors="replace") as dump_file:
+            dump_lines = dump_file.read().splitlines()
+
+    addresses = []
+    for line in dump_lines:
+        match = CALL_SITE_PATTERN.match(line)
+        if match:
+            addresses.append(int(match.group(2), 16) - load_base)
+
+    symbols = iter(symbolize(arguments.addr2line, arguments.elf, addresses))
+    for line in dump_lines:
+        if CALL_SITE_PATTERN.match(line):
+            print("%s at %s" % (line, next(symbols)))
+        else:
+            print(line)
+
+
+if __name__ == "__main__":
+    main()